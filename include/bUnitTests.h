@@ -3,7 +3,7 @@
 //--File Info-----------------------------------------------------------------------------------------------------------
 
 /// @file bUnitTests.h
-/// @version 1.3.0
+/// @version 1.34.2
 /// @brief "header only" unit testing framework/application
 ///
 /// The "header only" mentioned above is a little bit of a lie. While this file _does_ contain everything that is needed
@@ -65,17 +65,381 @@
 ///
 /// If any of the tests would produce an output to std::cout, they are instead redirected to a log file (default name
 /// "tests.txt") which contains the output for each test. The name of the log file can be controlled by providing a
-/// definition for bTESTS_LOG_FILE. Logging to a file can be disabled by defining bTESTS_NO_LOG, in which case all
-/// outputs are discarded and a log file is not generated -- test results will still print to the console, however.
+/// definition for bTESTS_LOG_FILE. The log is written by a background thread (through a ring of buffers of
+/// bTESTS_LOG_BUFFER_SIZE bytes), and whatever is still buffered is written out if the application crashes. Logging
+/// to a file can be disabled by defining bTESTS_NO_LOG, in which case all outputs are discarded and a log file is not
+/// generated -- test results will still print to the console, however.
 ///
-/// Functionality for grouping tests has been provided-- tests are run for each group in sequence, so grouped tests will
-/// have their outputs closer together in the log file. Ungrouped tests belong to a group named "ungrouped". To see an
+/// Functionality for grouping tests has been provided-- tests are run for each group in sequence (groups sorted by
+/// name, then tests sorted by name within each group), so grouped tests will have their outputs closer together in the
+/// log file. Ungrouped tests belong to a group named "ungrouped". To see an
 /// example test "implementation", see the bottom of this file (above the license).
+///
+/// Tests can be run in parallel on a pool of worker threads by passing "--jobs N" (or "-j N") to the test application,
+/// where N is the number of worker threads (0 uses one thread per hardware thread). Defining bTESTS_PARALLEL makes
+/// parallel execution (on all hardware threads) the default. Results are still printed per group, in the same order
+/// the serial runner would print them.
+///
+/// Passing "--isolate" (or defining bTESTS_ISOLATE) runs the tests in a pool of worker processes instead (POSIX only;
+/// the tests run in-process elsewhere). The workers are forked once and reused, and default to one per hardware thread
+/// unless "--jobs N" is given. A test which crashes, exits, or runs for longer than "--timeout S" seconds only fails
+/// itself-- its worker is replaced and the run carries on.
+///
+/// A watchdog thread enforces the timeouts of tests which run in-process: "--timeout S" (or a "timeout=S" attribute on
+/// the test, see bTEST_FUNCTION) is the longest a test may run for, and "--global-timeout S" the longest the whole run
+/// may take. A hung test can't be stopped safely, so when a timeout is hit the watchdog reports the test, lists the
+/// tests which were still running, writes out the log, and ends the application (returning failure).
+///
+/// Tests which can't share the machine say so with attributes (see bTEST_FUNCTION): "exclusive" tests run alone,
+/// "threads=N" tests take N of the workers, and at most one test at a time uses each "resource=R" (or as many as
+/// "--resource-limits R=N,..." allows, bTESTS_RESOURCE_LIMITS by default). The parallel (and isolated) runners put
+/// aside the tests which can't start yet and run the rest, so everything else still uses every worker.
+///
+/// Table driven tests can be written with bTEST_PARAMETERIZED, which registers one test case per value (named
+/// "name[index]"), so each case is scheduled, filtered, and reported on its own. Property tests, written with
+/// bTEST_PROPERTY, check their body with many inputs made by the generators in ben::tests::gen ("--property-cases N",
+/// 1000 by default); the first input which fails is shrunk to a minimal counterexample, which is written to the log.
+/// bTEST_PROPERTY_FUZZER turns a property test into a libFuzzer entry point.
+///
+/// Async tests, written with bTEST_ASYNC, are C++20 coroutines (returning ben::tests::Task<>) which the runner drives
+/// on a shared event loop of bTESTS_ASYNC_THREADS threads (2 by default): while one awaits (ben::tests::sleep_for, or
+/// a ben::tests::AsyncEvent set by the completion of some I/O) the others keep running, so many of them can be in
+/// flight at once. They're reported and timed out just like the other tests; one which is still waiting when its
+/// timeout passes fails as timed out, and its coroutine is abandoned rather than destroyed.
+///
+/// With "--quiet" (or "-q", or defining bTESTS_QUIET) only the failing tests are printed to the console, along with a
+/// progress line (on a terminal) which is redrawn every bTESTS_PROGRESS_INTERVAL_MS at most; the log file still gets
+/// the full details of every test.
+///
+/// Benchmarks can be defined alongside the tests with bBENCHMARK_FUNCTION; they run (serially) after the tests, and can
+/// be skipped with "--no-benchmarks".
+///
+/// The tests (and benchmarks) can be split across several machines with "--shard-index I --total-shards N" (or the
+/// bTESTS_SHARD_INDEX and bTESTS_TOTAL_SHARDS environment variables): each test is assigned to a shard by a stable
+/// hash of its group and name, and only the tests in shard I (counting from 0) are run.
+///
+/// Each run records the outcome and wall time of every test in a history file (default name "tests.history", which can
+/// be changed by defining bTESTS_HISTORY_FILE or passing "--history FILE"; defining bTESTS_NO_HISTORY or passing
+/// "--no-history" disables it). Parallel runs start the slowest tests (according to the history) first. Passing
+/// "--shard-timings FILE" balances the shards using the timings in a history file instead of hashing: the tests are
+/// packed into the shards longest first, so every shard should take about the same time.
+///
+/// Passing "--cache" (or defining bTESTS_CACHE) skips the tests which passed in the run recorded by the history, if
+/// their translation unit hasn't been rebuilt since: each test is registered with a fingerprint of its file name and
+/// bTESTS_BUILD_ID (the time the file was compiled, unless it's defined to something else). "--no-cache" runs them all.
+/// The default build id makes the build unreproducible; defining bTESTS_REPRODUCIBLE_BUILD leaves it (and the
+/// fingerprints) out, so nothing is cached unless bTESTS_BUILD_ID is defined.
+///
+/// "--fail-fast" stops starting tests (and skips the benchmarks) after the first failure, or after N failures with
+/// "--fail-fast=N"; the tests which were already running still finish and are reported. "--failed-first" runs the
+/// tests which didn't pass in the run recorded by the history first: the groups with a failure come first, and within
+/// those groups the failed tests do (so each group still runs all together, and shares its fixtures).
+///
+/// "--shuffle" (or defining bTESTS_SHUFFLE) runs the groups, and the tests within each group, in a random order, which
+/// is printed as a seed; "--seed N" shuffles them into the same order again (on any platform), to reproduce a failure
+/// which depends on the order the tests run in.
+///
+/// "--repeat N" runs each test N times, and "--repeat-until-fail" stops repeating a test at its first failure (if it's
+/// given without "--repeat", the tests repeat until they fail). "--stress K" runs each repetition on K threads at once.
+/// The repetitions are reported as one result: the number of runs and failures, and the fastest, mean, and slowest
+/// run, along with the output (and failure) of the first failing run (or of the first run, if none failed). A test's
+/// timeout covers all of its repetitions.
+///
+/// "--filter PATTERNS" and "--group PATTERNS" only run the tests whose names (or groups) match one of the comma
+/// separated glob patterns ('*' and '?' are wildcards), and patterns starting with '-' exclude the tests they match.
+/// The filters are applied to the registered tests before anything else happens, and "--list" lists the selected tests
+/// without running them (or touching the log file).
+///
+/// "--junit FILE" writes the results as JUnit XML (one <testsuite> per group), and "--json FILE" writes them as JSON
+/// lines (one object per test or benchmark, then a summary). Both are written as the results come in, rather than at
+/// the end of the run.
+///
+/// Expensive setup can be shared with fixtures: ben::tests::group_fixture<T>() returns a T which is shared by every
+/// test in the calling test's group, ben::tests::suite_fixture<T>() one which is shared by every test in the run, and
+/// ben::tests::thread_fixture<T>() a (modifiable) copy per group and per worker thread. Each is default constructed
+/// the first time it's asked for, and destroyed (in reverse order of construction) once the last test of its group (or
+/// of the run) has finished.
+///
+/// Defining bTESTS_TRACK_ALLOCATIONS (where the implementation is compiled) replaces the global operator new/delete to
+/// count the allocations made by each test: the number of allocations, the bytes allocated, and the peak bytes live at
+/// once are printed next to its result, along with any bytes it allocated but never freed. bTEST_ASSERT_NO_ALLOC and
+/// bTEST_ASSERT_MAX_ALLOCS check the allocations made by a block of code.
+///
+/// Passing "--counters" (or defining bTESTS_COUNTERS) counts hardware events around each test and each benchmark loop:
+/// cycles, instructions, cache misses and branch misses (with perf_event_open, on Linux), from which the IPC and the
+/// misses per iteration of a benchmark are worked out. Where the hardware counters aren't available, the time stamp
+/// counter is read instead (on x86).
+///
+/// "--profile-runner" (or defining bTESTS_PROFILE_RUNNER) times the runner's own work, phase by phase (registration,
+/// scheduling, output capture, log I/O, and reporting), against the test bodies, and adds the breakdown to the
+/// summary. Defining bTESTS_SELF_BENCHMARK in the file with the implementation registers bTESTS_SELF_BENCHMARK_TESTS
+/// (100000 by default) empty tests, so the runner's overhead per test can be tracked over time. Defining
+/// bTESTS_SELF_TEST there registers the framework's own regression tests (in the group "bTESTS self test").
+///
+/// "--save-baseline FILE" saves the samples of every benchmark, and "--baseline FILE" compares a later run with them
+/// using a Mann-Whitney U test. A benchmark regresses if it's significantly slower (p below
+/// bTESTS_BASELINE_SIGNIFICANCE) by more than "--regression-threshold P" percent (bTESTS_REGRESSION_THRESHOLD, 5 by
+/// default), which fails the run; improvements and changes within the noise are reported separately.
+///
+/// "--trend-file FILE" (or bTESTS_TREND_FILE) appends the timings, allocations, and hardware counts of every test and
+/// benchmark in each run to a compact binary file, tagged with "--trend-tag TAG" (bTESTS_TREND_TAG, e.g. a commit
+/// hash; bTESTS_BUILD_ID by default). "--trend PATTERN" prints the runs of the matching tests instead of running
+/// anything, and flags the run where a test's time stepped up or down.
 
 //--Changelog---------------------------------------------------------------------------------------------------------//
 /*                                                                                                                    //
 // This section was introduced in file version 1.1.0 to track the changes which are made to the file.                 //
 //                                                                                                                    //
+//  v1.34.2 -   The public header now includes <algorithm>, which the generators of property tests use (it was only   //
+//              included indirectly before).                                                                          //
+//                                                                                                                    //
+//  v1.34.1 -   Fixed a property test passing when its counterexample passed when run directly but failed in the      //
+//              trial after it. A counterexample now always fails the test. The failure is reported at the            //
+//              bTEST_PROPERTY's own file and line instead of "property:0".                                           //
+//                                                                                                                    //
+//  v1.34.0 -   Defining bTESTS_REPRODUCIBLE_BUILD keeps __DATE__ and __TIME__ out of the default bTESTS_BUILD_ID, so //
+//              the build is reproducible and -Wdate-time stays quiet. Without a build id the tests aren't            //
+//              fingerprinted, so "--cache" never skips them. The message about cached tests now agrees with their    //
+//              count.                                                                                                //
+//                                                                                                                    //
+//  v1.33.1 -   Fixed async tests being timed out early by the deadline of an earlier async test, and late resumes    //
+//              reaching the wrong test. This happened when a test was allocated at the address of one which had just //
+//              finished. The event loop now refers to each test by an id which is never reused, so a stale deadline  //
+//              or resume is dropped.                                                                                 //
+//                                                                                                                    //
+//              Defining bTESTS_SELF_TEST registers the framework's own regression tests (in the group "bTESTS self   //
+//              test"), starting with this one.                                                                       //
+//                                                                                                                    //
+//  v1.33.0 -   Added a trend file: "--trend-file FILE" (or bTESTS_TREND_FILE) appends the time, CPU time,            //
+//              allocations, and hardware counts of every test and benchmark in the run to an append-only, column by  //
+//              column binary file, tagged with "--trend-tag TAG" (bTESTS_TREND_TAG, bTESTS_BUILD_ID by default).     //
+//                                                                                                                    //
+//              "--trend PATTERN" prints the recorded runs of the matching tests without running anything, and flags  //
+//              the run where the time of a test stepped up or down (the best least squares split of the passing      //
+//              runs, if it's significant by a Mann-Whitney U test at bTESTS_TREND_SIGNIFICANCE and bigger than       //
+//              "--regression-threshold"; at least bTESTS_TREND_MIN_RUNS runs on each side).                          //
+//                                                                                                                    //
+//  v1.32.0 -   Added the test attributes "exclusive" (run alone), "threads=N" (take N of the workers), and           //
+//              "resource=R" (or "resource=R+S"; at most one test at a time uses R, or as many as "--resource-limits  //
+//              R=N,..." / bTESTS_RESOURCE_LIMITS allows), which the parallel and isolated runners respect.           //
+//                                                                                                                    //
+//              Tests which can't start yet are put aside while the rest run, and tests waiting for threads aren't    //
+//              starved by smaller ones; runs without these attributes don't lock anything.                           //
+//                                                                                                                    //
+//  v1.31.0 -   Added bTEST_ASYNC(name, group) for async tests: C++20 coroutines returning ben::tests::Task<> which   //
+//              the runner drives on a shared event loop of bTESTS_ASYNC_THREADS threads (2 by default), so many      //
+//              tests waiting on I/O can be in flight at once.                                                        //
+//                                                                                                                    //
+//              Tests can co_await ben::tests::sleep_for, other Task<T>s, and ben::tests::AsyncEvent (which any       //
+//              thread can set), and assert with bTEST_CO_ASSERT. They're reported, logged, and timed out like the    //
+//              other tests; a timed out coroutine is abandoned.                                                      //
+//                                                                                                                    //
+//  v1.30.0 -   Added "--quiet" (or "-q", or define bTESTS_QUIET), which only prints the failing tests to the         //
+//              console, plus a progress line on terminals. The line is redrawn at most every                         //
+//              bTESTS_PROGRESS_INTERVAL_MS (100 ms), and the batched output goes out in one write per redraw. The    //
+//              log file still gets every test in full.                                                               //
+//                                                                                                                    //
+//  v1.29.0 -   Added "--profile-runner" (or define bTESTS_PROFILE_RUNNER), which times the runner's own work against //
+//              the test bodies. Its phases are registration, scheduling, output capture, log I/O and reporting, and  //
+//              the totals are summed over every thread into a section of the summary.                                //
+//                                                                                                                    //
+//              Defining bTESTS_SELF_BENCHMARK registers bTESTS_SELF_BENCHMARK_TESTS (100000) empty tests, to track   //
+//              the overhead per test.                                                                                //
+//                                                                                                                    //
+//  v1.28.0 -   Added bTEST_PROPERTY(name, group, generators...) for property tests, with the generators integers,    //
+//              reals, booleans, strings, vectors and tuples in ben::tests::gen. Inputs are generated in place from a //
+//              splitmix64 seed, and grow over "--property-cases N" (1000 by default).                                //
+//                                                                                                                    //
+//              The first failing input is shrunk to a minimal counterexample, which is logged and then run again.    //
+//              "--property-seed N" varies the inputs, and bTEST_PROPERTY_FUZZER(name) adds a libFuzzer entry point.  //
+//                                                                                                                    //
+//  v1.27.0 -   Added "--shuffle" (or defining bTESTS_SHUFFLE) and "--seed N": the groups, and the tests within each  //
+//              group, are shuffled from the sorted order with a (printed) seed, reproducibly across standard         //
+//              libraries. "--failed-first" keeps the shuffled order of the groups.                                   //
+//                                                                                                                    //
+//  v1.26.0 -   Added "--repeat N", "--repeat-until-fail", and "--stress K" (each repetition runs on K threads,       //
+//              released together by a std::latch). The runs of a test are aggregated into one result with the number //
+//              of runs and failures and the min/mean/max run time, which is printed, serialized for worker           //
+//              processes, and written to the JSON results.                                                           //
+//                                                                                                                    //
+//  v1.25.0 -   Added "--fail-fast[=N]", which stops starting tests after the first (or N) failures and skips the     //
+//              benchmarks, in serial, threaded, and isolated runs. Tests which weren't run aren't recorded in the    //
+//              history, and the summary says how many there were.                                                    //
+//                                                                                                                    //
+//              Added "--failed-first", which runs the groups with a failure in the history first (the failed tests   //
+//              first within them), and starts the failed tests first when running in parallel.                       //
+//                                                                                                                    //
+//  v1.24.0 -   Added a result cache: "--cache" (or defining bTESTS_CACHE) skips the tests which passed in the run    //
+//              recorded by the history, if their translation unit hasn't been rebuilt since. "--no-cache" runs them  //
+//              all, and the skipped tests are counted in the output and the summary.                                 //
+//                                                                                                                    //
+//              Each test is registered with a fingerprint of __FILE__ and bTESTS_BUILD_ID (which defaults to         //
+//              __DATE__ " " __TIME__), and the history records it. Lines without a fingerprint (from older versions) //
+//              are still read.                                                                                       //
+//                                                                                                                    //
+//  v1.23.0 -   bTEST_FUNCTION and bBENCHMARK_FUNCTION no longer define a class (with a virtual destructor) per test. //
+//              They forward declare the function and register a constant ben::tests::detail::Registration made by    //
+//              make_registration, through the new bTEST_REGISTER macro.                                              //
+//                                                                                                                    //
+//              On ELF targets with GCC or clang, a pointer to each registration is placed in the                     //
+//              "bTESTS_registrations" linker section, so there is no dynamic initialization per test. Elsewhere, or  //
+//              with bTESTS_NO_LINKER_SECTION defined, a ben::tests::detail::Registrar pushes the registration onto   //
+//              the list during static initialization.                                                                //
+//                                                                                                                    //
+//              The UnitTest class is still available for code which registers tests by hand.                         //
+//                                                                                                                    //
+//  v1.22.0 -   Added bTEST_PARAMETERIZED(name, group, values...) for table driven tests: each value becomes its own  //
+//              test case (named "name[index]"), which is scheduled, filtered, and reported like any other test. The  //
+//              cases are generated at compile time and registered by a single object per table.                      //
+//                                                                                                                    //
+//              The public header now includes <array> and <utility>.                                                 //
+//                                                                                                                    //
+//  v1.21.0 -   Added benchmark baselines: "--save-baseline FILE" saves the samples of each benchmark, and            //
+//              "--baseline FILE" compares a later run with them using a Mann-Whitney U test. A benchmark which is    //
+//              significantly slower (p below bTESTS_BASELINE_SIGNIFICANCE) by more than "--regression-threshold P"   //
+//              percent (bTESTS_REGRESSION_THRESHOLD) fails the run.                                                  //
+//                                                                                                                    //
+//              Regressions, improvements, and unchanged benchmarks (within the noise) are reported separately, in    //
+//              the console, the summary, and the JSON report; regressions are failures in the JUnit report.          //
+//                                                                                                                    //
+//  v1.20.0 -   Added "--counters" (or define bTESTS_COUNTERS) to count hardware events around each test and each     //
+//              benchmark loop: cycles, instructions, cache misses, and branch misses, with perf_event_open on Linux. //
+//              Tests report the totals and their IPC, benchmarks report the counts per iteration; both are also      //
+//              written to the JSON report.                                                                           //
+//                                                                                                                    //
+//              Where perf_event_open isn't available (or allowed), the time stamp counter is read instead on x86,    //
+//              and the reason is printed at the start of the run.                                                    //
+//                                                                                                                    //
+//  v1.19.0 -   Added opt-in allocation tracking (bTESTS_TRACK_ALLOCATIONS), which replaces the global operator       //
+//              new/delete with versions which count the allocations (and bytes, and peak live bytes) made by each    //
+//              thread. The counts for each test are printed with its result (and written to the JSON report), along  //
+//              with any bytes it leaked.                                                                             //
+//                                                                                                                    //
+//              Added bTEST_ASSERT_NO_ALLOC and bTEST_ASSERT_MAX_ALLOCS to check the allocations made by a block of   //
+//              code, and bTEST_ASSERT_DESCRIBED (which bTEST_ASSERT now forwards to) to report a description instead //
+//              of the text of the expression.                                                                        //
+//                                                                                                                    //
+//  v1.18.0 -   Added fixtures for expensive setup which is shared between tests: ben::tests::group_fixture<T>()      //
+//              (shared by the tests in a group), ben::tests::suite_fixture<T>() (shared by the whole run), and       //
+//              ben::tests::thread_fixture<T>() (a modifiable copy per group and per worker thread).                  //
+//                                                                                                                    //
+//              Fixtures are built lazily (the first time a test asks for one, outside of any lock so different       //
+//              groups build theirs in parallel) and are torn down in reverse order of construction once the last     //
+//              test of their group (or the run) has finished.                                                        //
+//                                                                                                                    //
+//  v1.17.0 -   Added timeouts for tests which run in-process, enforced by a watchdog thread (which checks every      //
+//              bTESTS_WATCHDOG_INTERVAL_MS and is only started if there's a timeout to enforce). "--timeout S" now   //
+//              applies to every test, a test can set its own timeout with an attribute string after its group (e.g.  //
+//              bTEST_FUNCTION(name, "group", "timeout=5")), and "--global-timeout S" limits the whole run. When a    //
+//              test in this process times out, the watchdog reports it along with every test still running, writes   //
+//              out the log, and ends the run; with process isolation only the worker is killed.                      //
+//                                                                                                                    //
+//              Tests and benchmarks now take an (optional) third macro argument: a string of comma separated         //
+//              "key=value" attributes. Timeouts may be fractional.                                                   //
+//                                                                                                                    //
+//  v1.16.0 -   Added machine readable reporters: "--junit FILE" writes JUnit XML (a <testsuite> per group; only the  //
+//              current group is buffered, since its counts are attributes), and "--json FILE" writes a JSON line per //
+//              test/benchmark as it finishes, then a summary line. The statistics of a benchmark are now computed    //
+//              separately from their description, so the reporters can use them.                                     //
+//                                                                                                                    //
+//  v1.15.0 -   The log file is now written by a background thread. Output is batched into a lock-free (single        //
+//              producer/single consumer) ring of large buffers, bTESTS_LOG_BUFFER_SIZE bytes each, so the thread     //
+//              reporting the results doesn't wait on the file system. The buffers are written out when the           //
+//              application exits, and (on a best effort basis) if it crashes.                                        //
+//                                                                                                                    //
+//  v1.14.0 -   Added "--filter PATTERNS" and "--group PATTERNS", which only select the tests whose names/groups      //
+//              match one of the (comma separated) glob patterns; patterns starting with '-' exclude tests. The       //
+//              filters are applied to the registry before the tests are collected (and before sharding), and         //
+//              "--list" lists the selected tests and benchmarks without running them.                                //
+//                                                                                                                    //
+//              The log file is now opened the first time something is written to it, so listing the tests doesn't    //
+//              overwrite it                                                                                          //
+//                                                                                                                    //
+//  v1.13.0 -   Added a history file ("tests.history", controlled by bTESTS_HISTORY_FILE/bTESTS_NO_HISTORY or         //
+//              "--history FILE"/"--no-history") which records the outcome and wall time of each test. Parallel runs  //
+//              (threads or worker processes) start the slowest tests first according to the history.                 //
+//                                                                                                                    //
+//              "--shard-timings FILE" balances the shards with the timings in a history file: the tests are assigned //
+//              longest first to the shard with the least work so far, instead of by hash                             //
+//                                                                                                                    //
+//  v1.12.0 -   Added sharding: "--shard-index I --total-shards N" (or the bTESTS_SHARD_INDEX and bTESTS_TOTAL_SHARDS //
+//              environment variables) only runs the tests and benchmarks in shard I. Each test is assigned to a      //
+//              shard by a 64 bit FNV-1a hash of its group and name, so the split is the same on every machine and    //
+//              doesn't depend on what else is registered.                                                            //
+//                                                                                                                    //
+//  v1.11.0 -   Added bTEST_EXPECT, a non-fatal assertion which records its failure (in the test's log) and lets the  //
+//              test carry on; the test fails when it returns and reports how many checks failed                      //
+//                                                                                                                    //
+//              Builds without exceptions are supported: bTEST_ASSERT records its failure and returns instead of      //
+//              throwing, and the runner no longer relies on exceptions to detect failures                            //
+//                                                                                                                    //
+//  v1.10.0 -   bTEST_ASSERT no longer builds a std::string (or throws a std::exception constructed from a c str,     //
+//              which isn't portable). The file name of the assertion is picked out of __FILE__ at compile time by a  //
+//              constexpr function, and a failed assertion throws a ben::tests::AssertionFailure which only holds     //
+//              pointers to string literals (the file name and the text of the expression) plus the line number-- so  //
+//              failing an assertion doesn't allocate. The runner formats the location (and prints the failed         //
+//              expression) when it reports the result.                                                               //
+//                                                                                                                    //
+//              Tests which throw something which isn't a std::exception are now reported as failures instead of      //
+//              escaping the runner.                                                                                  //
+//                                                                                                                    //
+//  v1.9.0  -   Replaced the (unordered) map of (unordered) maps of tests with an intrusive linked list of            //
+//              registrations. Each UnitTest now holds its own registration (pointers to the name and group literals  //
+//              from the macro, and the function pointer) and pushes it onto a constant-initialized list head when it //
+//              is constructed, so registering a test never allocates.                                                //
+//                                                                                                                    //
+//              The first time the tests are needed the list is copied into a single contiguous array and sorted by   //
+//              group and then by name, so the run order is deterministic (it used to be hash order). As before,      //
+//              registering the same group and name twice keeps the later registration.                               //
+//                                                                                                                    //
+//  v1.8.0  -   Every test (and benchmark) is now timed with a monotonic clock (wall time) and the CPU clock of the   //
+//              thread which runs it. Both times are printed next to the result of the test on the console and in the //
+//              log file, and the summary lists the slowest tests by wall time ("--slowest N", defaulting to          //
+//              bTESTS_SLOWEST, which is 5).                                                                          //
+//                                                                                                                    //
+//              Results sent back from worker processes are now serialized by a pair of helpers rather than a fixed   //
+//              header; tests which crash or time out in a worker are given the wall time seen by the parent process. //
+//                                                                                                                    //
+//  v1.7.0  -   Added benchmarks. bBENCHMARK_FUNCTION(name, group) registers a benchmark in the same map as the       //
+//              tests; its body loops over a ben::tests::Benchmark ("state"), and only the loop is timed. Each        //
+//              benchmark is warmed up and calibrated (so a sample takes about bTESTS_BENCHMARK_SAMPLE_MS), then      //
+//              bTESTS_BENCHMARK_SAMPLES samples are measured and the min/median/mean/standard deviation of the time  //
+//              per iteration and the (median) rate are reported. ben::tests::do_not_optimize and                     //
+//              ben::tests::clobber_memory keep the compiler from deleting the measured code.                         //
+//                                                                                                                    //
+//              Benchmarks run serially, in-process, after the tests; "--no-benchmarks" skips them. A benchmark which //
+//              throws fails the run.                                                                                 //
+//                                                                                                                    //
+//  v1.6.0  -   Added a process isolation mode ("--isolate", or define bTESTS_ISOLATE) for POSIX systems. The tests   //
+//              are run by a pool of worker processes which are forked up front and reused from test to test; each    //
+//              worker reads a test index from a pipe, runs the test (capturing its output as usual), and writes the  //
+//              serialized result back. A worker which dies part way through a test is reported as a crash of that    //
+//              test (with the signal or exit code), then replaced, and the run continues. "--timeout S" kills and    //
+//              replaces any worker whose test runs for longer than S seconds. The pool defaults to one worker per    //
+//              hardware thread unless "--jobs N" is given.                                                           //
+//                                                                                                                    //
+//              Results now carry a status (passed, failed, crashed, timed out) instead of a pass/fail flag, and      //
+//              g_successes is incremented when a result is reported rather than when the test finishes.              //
+//                                                                                                                    //
+//  v1.5.0  -   Replaced the swapping of std::cout's buffer around each test with per-thread output capture.          //
+//              std::cout is now routed through a (thread aware) stream buffer for the whole run; each test's output  //
+//              is captured straight into its own in-memory buffer and written to the log file in a single write once //
+//              the test is reported, along with the "header" and result lines. The serial and parallel runners now   //
+//              share the same code for running and reporting a test.                                                 //
+//                                                                                                                    //
+//              The summary is also built once and written to both the console and the log file, rather than swapping //
+//              std::cout's buffer to write it twice.                                                                 //
+//                                                                                                                    //
+//  v1.4.0  -   Added an (opt-in) parallel test runner. Passing "--jobs N" (or "-j N") to the test application runs   //
+//              the tests on N worker threads (0 means one per hardware thread); defining bTESTS_PARALLEL makes that  //
+//              the default. Each worker owns a queue of tests and steals from the back of the other queues once its  //
+//              own queue is empty, so a few slow tests don't leave the other workers idle. Output from a test is     //
+//              captured per thread while running in parallel, and the results are reported per group in the same     //
+//              order as the serial runner would report them.                                                         //
+//                                                                                                                    //
+//              g_successes is now a std::atomic so it can be incremented from the worker threads. The entry point    //
+//              now accepts command line arguments. std::cout's buffer is swapped using the (standard) rdbuf setter.  //
+//                                                                                                                    //
 //  v1.3.0  -   Added documentation to the git repo. No changes to this file directly, but wanted to "unify" the      //
 //              number in the documentation and the file itself!                                                      //
 //                                                                                                                    //
@@ -124,8 +488,24 @@
 
 //--Includes------------------------------------------------------------------------------------------------------------
 
-#include <exception> // the "core" of our testing framework; failing tests are caught via thrown exceptions
-#include <string>    // for strings
+#include <algorithm>   // for std::min (in the generators of property tests)
+#include <array>       // for the values (and registrations) of parameterized tests
+#include <atomic>      // for the events async tests await
+#include <chrono>      // for timing benchmarks
+#include <coroutine>   // for async (coroutine) tests
+#include <cstddef>     // for size_t
+#include <cstdint>     // for the random numbers of property tests
+#include <exception>   // the "core" of our testing framework; failing tests are caught via thrown exceptions
+#include <limits>      // for the ranges of the generators of property tests
+#include <optional>    // for the values of the coroutines async tests await
+#include <string>      // for strings
+#include <tuple>       // for the inputs of property tests with several generators
+#include <type_traits> // for choosing how to hide values from the optimizer in benchmarks
+#include <utility>     // for expanding parameterized tests into their cases
+#include <vector>      // for the (generated) inputs of property tests, and their shrinking
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h> // for _ReadWriteBarrier
+#endif                  // _MSC_VER && !__clang__
 
 //--Macros--------------------------------------------------------------------------------------------------------------
 
@@ -136,52 +516,340 @@
 #    define bFILE_PATH_SEPARATOR '/' ///< file path separator (not Windows)
 #endif                               // _WIN32
 
+// register the tests through a linker section where it's supported (ELF targets, with GCC or clang), unless the user
+// asks not to by defining bTESTS_NO_LINKER_SECTION
+#if !defined(bTESTS_NO_LINKER_SECTION) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#    define bTESTS_USE_LINKER_SECTION ///< defined if the tests are registered through a linker section
+#endif // !bTESTS_NO_LINKER_SECTION && __ELF__ && (__GNUC__ || __clang__)
+
+#ifndef bTESTS_BUILD_ID
+#    ifdef bTESTS_REPRODUCIBLE_BUILD
+// without __DATE__ and __TIME__ nothing tells the builds apart, so the tests aren't fingerprinted (see below)
+#        define bTESTS_BUILD_ID ""
+#        define bTESTS_NO_BUILD_ID
+#    else
+/// @brief identifies the build of each translation unit (as a string literal) in the fingerprints of its tests, which
+/// "--cache" compares with the history. Defaults to the time the translation unit was compiled; if the code being
+/// tested is built separately (e.g. into a library), define it to something which changes along with that code instead.
+/// The default also makes the build unreproducible (and trips -Wdate-time), so define it (e.g. to a commit hash), or
+/// define bTESTS_REPRODUCIBLE_BUILD to leave the tests without fingerprints ("--cache" then never skips them)
+#        define bTESTS_BUILD_ID __DATE__ " " __TIME__
+#    endif // bTESTS_REPRODUCIBLE_BUILD
+#endif     // !bTESTS_BUILD_ID
+
+#ifndef bTESTS_PROPERTY_SHRINKS
+/// @brief the most inputs a property test tries while shrinking a counterexample (see bTEST_PROPERTY)
+#    define bTESTS_PROPERTY_SHRINKS 1000
+#endif // !bTESTS_PROPERTY_SHRINKS
+
+#ifdef bTESTS_NO_BUILD_ID
+/// @brief the fingerprint of the translation unit this is expanded in (unknown, without a bTESTS_BUILD_ID)
+#    define bTESTS_FINGERPRINT 0ull
+#else
+/// @brief the fingerprint of the translation unit this is expanded in (a hash of its file name and bTESTS_BUILD_ID)
+#    define bTESTS_FINGERPRINT ben::tests::detail::get_fingerprint(__FILE__ "\n" bTESTS_BUILD_ID)
+#endif // bTESTS_NO_BUILD_ID
+
+#ifdef bTESTS_USE_LINKER_SECTION
+/// @brief registers a test (or benchmark) function; used by bTEST_FUNCTION and bBENCHMARK_FUNCTION
+///
+/// the registration is a constant (so there's nothing to do at startup), and a pointer to it is placed in the
+/// "bTESTS_registrations" linker section, which the linker gathers (from every translation unit) into one array
+///
+/// @param fName the name of the test
+/// @param func the function which implements the test (or benchmark)
+///
+/// @note the variadic arguments are the (optional) group and attributes of the test
+#    define bTEST_REGISTER(fName, func, ...)                                                                           \
+        namespace                                                                                                      \
+        {                                                                                                              \
+            constexpr ben::tests::detail::Registration g_##fName##Registration{                                        \
+                ben::tests::detail::make_registration(bTESTS_FINGERPRINT, #fName, func, ##__VA_ARGS__)};               \
+            [[gnu::used, gnu::section("bTESTS_registrations")]] const ben::tests::detail::Registration                 \
+                *const g_##fName##Test{&g_##fName##Registration};                                                      \
+        }
+#else
+/// @brief registers a test (or benchmark) function; used by bTEST_FUNCTION and bBENCHMARK_FUNCTION
+///
+/// without a linker section, the (constant) registration is copied onto the front of the list of registrations
+/// (during static initialization) by a (non-polymorphic) ben::tests::detail::Registrar
+///
+/// @param fName the name of the test
+/// @param func the function which implements the test (or benchmark)
+///
+/// @note the variadic arguments are the (optional) group and attributes of the test
+#    define bTEST_REGISTER(fName, func, ...)                                                                           \
+        namespace                                                                                                      \
+        {                                                                                                              \
+            constexpr ben::tests::detail::Registration g_##fName##Registration{                                        \
+                ben::tests::detail::make_registration(bTESTS_FINGERPRINT, #fName, func, ##__VA_ARGS__)};               \
+            inline static const ben::tests::detail::Registrar g_##fName##Test{g_##fName##Registration};               \
+        }
+#endif // bTESTS_USE_LINKER_SECTION
+
 /// @brief test function convenience macro (optionally grouped with a second argument)
 ///
 /// creates a forward declaration to a function which returns a bTestFunc_return_t using the provided "name", then
-/// creates a special struct which inherits from the base UnitTest struct and "forwards" the forward-declared function
-/// to the UnitTest base struct ctor. Creates a (global, inline, static, const) instance of the specialized class (all
-/// within an anonymous namespace to prevent clashing, etc.), then begins the definition of the actual test function
-/// which was forward declared! Expects the user to provide the body of the function (in brackets) after the macro
-/// appears
+/// registers it (see bTEST_REGISTER-- there's no class, and normally nothing to run at startup, per test). Then begins
+/// the definition of the actual test function which was forward declared! Expects the user to provide the body of the
+/// function (in brackets) after the macro appears
 ///
 /// @param fName the "name" of the test function-- can contain any character that is valid in a function signature (not
 /// whitespace) including underscores (but it cannot start with a number). Will not compile if the name is not valid!
 ///
-/// @note the variadic arguments are actually a single argument and it is the "group" the test belongs to-- used for
-/// organizational purposes and to group similar tests! Can be left blank for ungrouped tests (which is why it's a
-/// variadic argument)
+/// @note the variadic arguments are the (optional) "group" the test belongs to-- used for organizational purposes and
+/// to group similar tests! Can be left blank for ungrouped tests (which is why it's a variadic argument). The group can
+/// be followed by a string of attributes (comma separated "key=value" pairs), e.g. "timeout=5" to end the run if the
+/// test takes longer than 5 seconds (or just kill its worker process, when isolated). When the tests run in parallel,
+/// "exclusive" runs the test alone, "threads=N" counts it as N of the worker threads, and "resource=gpu" (or
+/// "resource=gpu+db" for several) limits how many tests use that resource at once (one, unless "--resource-limits"
+/// says otherwise), e.g. bTEST_FUNCTION(renders_scene, "gpu", "resource=gpu, threads=4")
 #define bTEST_FUNCTION(fName, ...)                                                                                     \
     ben::tests::bTestFnResultType fName##_TestFunc();                                                                  \
+    bTEST_REGISTER(fName, &fName##_TestFunc, ##__VA_ARGS__)                                                            \
+    inline ben::tests::bTestFnResultType fName##_TestFunc()
+
+/// @brief benchmark function convenience macro (optionally grouped with a second argument)
+///
+/// works just like bTEST_FUNCTION (and registers the benchmark alongside the tests), except the function which is
+/// declared takes a reference to a ben::tests::Benchmark named "state". The body should loop over the state, which
+/// runs the code being measured an (automatically calibrated) number of times:
+///
+///     bBENCHMARK_FUNCTION(vector_push_back, "containers")
+///     {
+///         for (auto _ : state)
+///         {
+///             std::vector<int> values;
+///             values.push_back(1);
+///             ben::tests::do_not_optimize(values);
+///         }
+///     }
+///
+/// @param fName the "name" of the benchmark function-- the same rules as for bTEST_FUNCTION apply (and the name must
+/// not clash with the name of a test)
+///
+/// @note the variadic arguments are the "group" the benchmark belongs to, optionally followed by its attributes (just
+/// like bTEST_FUNCTION)
+#define bBENCHMARK_FUNCTION(fName, ...)                                                                                \
+    void fName##_BenchFunc(ben::tests::Benchmark &state);                                                              \
+    bTEST_REGISTER(fName, &fName##_BenchFunc, ##__VA_ARGS__)                                                           \
+    inline void fName##_BenchFunc([[maybe_unused]] ben::tests::Benchmark &state)
+
+/// @brief async (coroutine) test function convenience macro (optionally grouped with a second argument)
+///
+/// works just like bTEST_FUNCTION, except the function which is declared is a coroutine returning a
+/// ben::tests::Task<>. The runner starts it on a shared event loop (of bTESTS_ASYNC_THREADS threads) and moves on, so
+/// while it awaits (e.g. ben::tests::sleep_for, or a ben::tests::AsyncEvent set by some I/O) the other tests keep
+/// running-- many async tests can be in flight at once. It's reported (and timed out) just like any other test:
+///
+///     bTEST_ASYNC(echoes_a_message, "network")
+///     {
+///         ben::tests::AsyncEvent replied;
+///         client.async_send("hello", [&replied](auto) { replied.set(); });
+///         co_await replied;
+///         bTEST_CO_ASSERT(client.last_reply() == "hello");
+///     }
+///
+/// @param fName the "name" of the test function (the same rules as for bTEST_FUNCTION apply)
+///
+/// @note the variadic arguments are the group and attributes of the test (just like bTEST_FUNCTION). The body must
+/// co_await (or co_return) at least once, and use bTEST_CO_ASSERT rather than bTEST_ASSERT
+#define bTEST_ASYNC(fName, ...)                                                                                        \
+    ben::tests::Task<> fName##_AsyncFunc();                                                                            \
+    bTEST_REGISTER(fName, &fName##_AsyncFunc, ##__VA_ARGS__)                                                           \
+    inline ben::tests::Task<> fName##_AsyncFunc()
+
+/// @brief parameterized (table driven) test convenience macro; registers one test case per value
+///
+/// works like bTEST_FUNCTION, except the function which is declared takes a reference to one of the values, named
+/// "value". The cases are expanded at compile time (there's a single registration object for the whole table, not a
+/// class and an object per case), and each one is scheduled, filtered, and reported on its own as "fName[index]":
+///
+///     bTEST_PARAMETERIZED(is_even, "math", 0, 2, 4, 1000)
+///     {
+///         bTEST_ASSERT(value % 2 == 0);
+///     }
+///
+/// @param fName the "name" of the test function (the same rules as for bTEST_FUNCTION apply)
+/// @param group the group the cases belong to
+///
+/// @note the variadic arguments are the values (all of the same type, which is deduced like std::array's); for tables
+/// of several inputs, pass structs, e.g. "Case{"abc", 3}, Case{"", 0}"
+#define bTEST_PARAMETERIZED(fName, group, ...)                                                                         \
     namespace                                                                                                          \
     {                                                                                                                  \
-        inline static const struct fName##_UnitTest : public ben::tests::UnitTest                                      \
-        {                                                                                                              \
-            fName##_UnitTest() : UnitTest{#fName, &fName##_TestFunc, ##__VA_ARGS__} {};                                \
-            virtual ~fName##_UnitTest()                               = default;                                       \
-            fName##_UnitTest(const fName##_UnitTest &)                = delete;                                        \
-            fName##_UnitTest(fName##_UnitTest &&) noexcept            = delete;                                        \
-            fName##_UnitTest &operator=(const fName##_UnitTest &)     = delete;                                        \
-            fName##_UnitTest &operator=(fName##_UnitTest &&) noexcept = delete;                                        \
-        } g_##fName##Test;                                                                                             \
+        inline static const auto fName##_ParamValues{std::array{__VA_ARGS__}};                                         \
     }                                                                                                                  \
-    inline ben::tests::bTestFnResultType fName##_TestFunc()
+    void fName##_ParamFunc(const decltype(fName##_ParamValues)::value_type &value);                                    \
+    namespace                                                                                                          \
+    {                                                                                                                  \
+        inline static const ben::tests::detail::ParameterizedTest<fName##_ParamValues, &fName##_ParamFunc>             \
+            g_##fName##Test{bTESTS_FINGERPRINT, #fName, group};                                                        \
+    }                                                                                                                  \
+    inline void fName##_ParamFunc([[maybe_unused]] const decltype(fName##_ParamValues)::value_type &value)
+
+/// @brief property test convenience macro; checks the body with many generated inputs
+///
+/// works like bTEST_FUNCTION, except the function which is declared takes a reference to a generated input, named
+/// "value" (a tuple, if several generators are given). The inputs grow from small to large over the run, and are the
+/// same on every run unless "--property-seed" is given; the first which fails is shrunk to a minimal counterexample,
+/// which is written to the log and then run again, so the test fails with the usual message:
+///
+///     bTEST_PROPERTY(reverse_twice, "strings", ben::tests::gen::strings{})
+///     {
+///         const std::string reversed(value.rbegin(), value.rend());
+///         bTEST_ASSERT(std::string(reversed.rbegin(), reversed.rend()) == value);
+///     }
+///
+/// @param fName the "name" of the test function (the same rules as for bTEST_FUNCTION apply)
+/// @param group the group the test belongs to
+///
+/// @note the variadic arguments are the generators (see ben::tests::gen), e.g. "gen::integers<int>{0, 100},
+/// gen::vectors{gen::booleans{}}"; the number of inputs is set by "--property-cases"
+#define bTEST_PROPERTY(fName, group, ...)                                                                              \
+    namespace                                                                                                          \
+    {                                                                                                                  \
+        inline static const auto fName##_PropGenerator{ben::tests::detail::make_property_generator(__VA_ARGS__)};      \
+    }                                                                                                                  \
+    void fName##_PropFunc(const decltype(fName##_PropGenerator)::value_type &value);                                   \
+    bTEST_FUNCTION(fName, group)                                                                                       \
+    {                                                                                                                  \
+        ben::tests::detail::check_property(ben::tests::detail::file_basename(__FILE__), __LINE__, #fName,              \
+                                           fName##_PropGenerator, &fName##_PropFunc);                                  \
+    }                                                                                                                  \
+    inline void fName##_PropFunc([[maybe_unused]] const decltype(fName##_PropGenerator)::value_type &value)
+
+/// @brief defines the entry point of a libFuzzer (or compatible) fuzzer for a property test
+///
+/// each input from the fuzzer is turned into a value by the property's generators (instead of random numbers), and an
+/// input which fails the property is described on stderr before aborting, so the fuzzer saves it. Build the fuzzer
+/// from a translation unit which defines bTEST_IMPLEMENTATION (but not bBUILD_TESTS, so there's no main) and expands
+/// this once, e.g. with "clang++ -fsanitize=fuzzer"
+///
+/// @param fName the "name" of the property test (see bTEST_PROPERTY)
+#define bTEST_PROPERTY_FUZZER(fName)                                                                                   \
+    extern "C" int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size)                                      \
+    {                                                                                                                  \
+        return ben::tests::detail::fuzz_property(fName##_PropGenerator, &fName##_PropFunc, data, size);                \
+    }
+
+// detect builds without exceptions (e.g. -fno-exceptions); the assertions can't throw in that case
+#if !defined(bTESTS_NO_EXCEPTIONS) && !defined(__cpp_exceptions) && !defined(_CPPUNWIND)
+#    define bTESTS_NO_EXCEPTIONS ///< defined if exceptions are disabled (can also be defined by the user)
+#endif                           // !bTESTS_NO_EXCEPTIONS && !__cpp_exceptions && !_CPPUNWIND
+
+#ifndef bTESTS_NO_EXCEPTIONS
+/// @brief test assertion macro which reports a description instead of the text of the expression, throws a
+/// ben::tests::AssertionFailure if the expression is not true
+///
+/// the location of the assertion (the file name, without its directories, and the line) is worked out at compile time,
+/// and the exception only holds pointers to string literals-- so a failing assertion never allocates
+///
+/// @param expr the expression to evaluate (must be true for the assertion to pass)
+/// @param description what the assertion checks (must be a string literal)
+///
+/// @note if exceptions are disabled (bTESTS_NO_EXCEPTIONS) the failure is recorded just like bTEST_EXPECT and the
+/// assertion returns from the enclosing function instead-- so it can only be used directly in the body of a test (or
+/// in a function returning void)
+#    define bTEST_ASSERT_DESCRIBED(expr, description)                                                                  \
+        do                                                                                                             \
+        {                                                                                                              \
+            if (!(expr))                                                                                               \
+            {                                                                                                          \
+                constexpr const char *bAssertFile_{ben::tests::detail::file_basename(__FILE__)};                       \
+                throw ben::tests::AssertionFailure{bAssertFile_, __LINE__, description};                               \
+            }                                                                                                          \
+        } while (false)
+#else
+#    define bTEST_ASSERT_DESCRIBED(expr, description)                                                                  \
+        do                                                                                                             \
+        {                                                                                                              \
+            if (!(expr))                                                                                               \
+            {                                                                                                          \
+                constexpr const char *bAssertFile_{ben::tests::detail::file_basename(__FILE__)};                       \
+                ben::tests::detail::record_failure(bAssertFile_, __LINE__, description);                               \
+                return;                                                                                                \
+            }                                                                                                          \
+        } while (false)
+#endif // !bTESTS_NO_EXCEPTIONS
+
+/// @brief test assertion macro, throws a ben::tests::AssertionFailure if the argument is not true (see
+/// bTEST_ASSERT_DESCRIBED, which this forwards to with the text of the expression)
+///
+/// @param expr the expression to evaluate (must be true for the assertion to pass)
+#define bTEST_ASSERT(expr) bTEST_ASSERT_DESCRIBED(expr, #expr)
 
-/// @brief test assertion macro, throws an exception if the argument is not true
+#ifndef bTESTS_NO_EXCEPTIONS
+/// @brief test assertion macro for coroutines (see bTEST_ASYNC); the same as bTEST_ASSERT, except that without
+/// exceptions (bTESTS_NO_EXCEPTIONS) it leaves the coroutine with co_return instead of return
 ///
 /// @param expr the expression to evaluate (must be true for the assertion to pass)
-#define bTEST_ASSERT(expr)                                                                                             \
+#    define bTEST_CO_ASSERT(expr) bTEST_ASSERT_DESCRIBED(expr, #expr)
+#else
+#    define bTEST_CO_ASSERT(expr)                                                                                      \
+        do                                                                                                             \
+        {                                                                                                              \
+            if (!(expr))                                                                                               \
+            {                                                                                                          \
+                constexpr const char *bAssertFile_{ben::tests::detail::file_basename(__FILE__)};                       \
+                ben::tests::detail::record_failure(bAssertFile_, __LINE__, #expr);                                     \
+                co_return;                                                                                             \
+            }                                                                                                          \
+        } while (false)
+#endif // !bTESTS_NO_EXCEPTIONS
+
+/// @brief non-fatal test assertion macro, records a failure (but carries on with the test) if the argument is not true
+///
+/// the test is marked as failed once it returns, and every failed expectation is listed in the log. Nothing is thrown,
+/// so this works even if exceptions are disabled
+///
+/// @param expr the expression to evaluate (must be true for the expectation to pass)
+#define bTEST_EXPECT(expr)                                                                                             \
     do                                                                                                                 \
     {                                                                                                                  \
         if (!(expr))                                                                                                   \
         {                                                                                                              \
-            std::string  errorString{std::string{__FILE__} + ":" + std::to_string(__LINE__)};                          \
-            const size_t lastSeparator{errorString.find_last_of(bFILE_PATH_SEPARATOR)};                                \
-            errorString = errorString.substr((lastSeparator == std::string::npos ? 0 : lastSeparator));                \
-            throw std::exception{errorString.c_str()};                                                                 \
+            constexpr const char *bExpectFile_{ben::tests::detail::file_basename(__FILE__)};                           \
+            ben::tests::detail::record_failure(bExpectFile_, __LINE__, #expr);                                         \
         }                                                                                                              \
     } while (false)
 
+/// @brief asserts that a block of code makes at most a given number of allocations (on the calling thread)
+///
+///     bTEST_ASSERT_MAX_ALLOCS(1, {
+///         std::vector<int> values;
+///         values.reserve(16);
+///     });
+///
+/// only allocations made through operator new are counted, and only if the implementation was compiled with
+/// bTESTS_TRACK_ALLOCATIONS defined-- otherwise the assertion always fails (rather than passing without checking
+/// anything). The number of allocations the block made is written to the log if the assertion fails
+///
+/// @param maxAllocs the most allocations the block may make
+///
+/// @note the variadic arguments are the block of code to run (so it may contain commas)
+#define bTEST_ASSERT_MAX_ALLOCS(maxAllocs, ...)                                                                        \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        const size_t bAllocsBefore_{ben::tests::detail::get_allocation_count()};                                       \
+        __VA_ARGS__                                                                                                    \
+        const size_t bAllocs_{ben::tests::detail::get_allocation_count() - bAllocsBefore_};                            \
+        bTEST_ASSERT_DESCRIBED(                                                                                        \
+            ben::tests::detail::check_allocations(bAllocs_, (maxAllocs)), "at most " #maxAllocs " allocation(s)");     \
+    } while (false)
+
+/// @brief asserts that a block of code doesn't allocate (on the calling thread); see bTEST_ASSERT_MAX_ALLOCS
+///
+/// @note the variadic arguments are the block of code to run (so it may contain commas)
+#define bTEST_ASSERT_NO_ALLOC(...)                                                                                     \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        const size_t bAllocsBefore_{ben::tests::detail::get_allocation_count()};                                       \
+        __VA_ARGS__                                                                                                    \
+        const size_t bAllocs_{ben::tests::detail::get_allocation_count() - bAllocsBefore_};                            \
+        bTEST_ASSERT_DESCRIBED(ben::tests::detail::check_allocations(bAllocs_, 0), "no allocations");                  \
+    } while (false)
+
 //--Unit Test Base Class------------------------------------------------------------------------------------------------
 
 namespace ben
@@ -195,261 +863,8105 @@ namespace ben
         /// @brief the type of function to use as a test function within the framework
         using bTestFnType = bTestFnResultType (*)();
 
-        /// @brief a struct which represents a unit test
-        /// @note this is intentionally "empty" (aside from a custom ctor) because the way the unit testing framework
-        /// implements tests is by inheriting from this (very basic) struct for each test to be implemented. The ctors
-        /// of the specific tests provide the arguments for this ctor, so the macro to create each individual test can
-        /// (indirectly) provide a name and a function to this ctor and everything plays nicely
-        struct UnitTest
+        namespace detail
         {
-          protected:
-            /// @brief accepts a name for the unit test (a c str) and a pointer to the function which implements the
-            /// test
-            /// @param name the name of the test (not necessarily the name of the function)
-            /// @param func a pointer to a bTestFunc_t (a function which takes no arguments and returns nothing) which
-            /// houses the test implementation
-            /// @param group the name of the group the test belongs to
-            UnitTest(const char *name, bTestFnType func, const char *group = "ungrouped");
+            /// @brief finds the file name (without any directories) in a path
+            /// @param path the path (usually __FILE__)
+            /// @return a pointer to the start of the file name within the path
+            /// @note constexpr so that bTEST_ASSERT can do this at compile time
+            constexpr const char *file_basename(const char *path)
+            {
+                const char *basename{path};
+                for (const char *c{path}; *c != '\0'; c++)
+                {
+                    if (*c == '/' || *c == bFILE_PATH_SEPARATOR)
+                    {
+                        basename = c + 1;
+                    }
+                }
+                return basename;
+            }
 
-            // we do NOT want to be able to copy/move/assign unit tests (that's nonsensical)
-            UnitTest()                                = delete;
-            UnitTest(const UnitTest &)                = delete;
-            UnitTest(UnitTest &&) noexcept            = delete;
-            UnitTest &operator=(const UnitTest &)     = delete;
-            UnitTest &operator=(UnitTest &&) noexcept = delete;
+            /// @brief records a (non-fatal) failure in the test running on the calling thread
+            /// @param file the name of the file containing the failed check (must be a string literal)
+            /// @param line the line of the failed check
+            /// @param expression the text of the expression which was false (must be a string literal)
+            void record_failure(const char *file, unsigned line, const char *expression) noexcept;
 
-          public:
-            /// @brief dtor is virtual since unit tests are to be inherited from
-            virtual ~UnitTest() = default;
-        };
-    } // namespace tests
-} // namespace ben
+            /// @brief counts the allocations made (through operator new) by the calling thread so far
+            /// @return the number of allocations (always 0 unless bTESTS_TRACK_ALLOCATIONS is defined)
+            size_t get_allocation_count() noexcept;
 
-//--Implementation------------------------------------------------------------------------------------------------------
+            /// @brief checks the number of allocations made by a block of code, logging them if there are too many
+            /// @param allocations the number of allocations the block made
+            /// @param maxAllocations the most allocations the block may make
+            /// @return true if allocations are tracked and there weren't too many
+            bool check_allocations(size_t allocations, size_t maxAllocations) noexcept;
 
-// only add the implementations to one single file where bTEST_IMPLEMENTATION is defined
-#ifdef bTEST_IMPLEMENTATION
-#    include <iostream>      // for printing to console, etc
-#    include <unordered_map> // for storing tests such that they can be accessed by group names and then test name
-#    ifndef bTESTS_NO_LOG
-#        include <fstream> // for outputting to a file
-#        ifndef bTESTS_LOG_FILE
-/// @brief the default log file name; if bTESTS_LOG_FILE is defined by the user (before this point) then that value is
-/// used instead
-#            define bTESTS_LOG_FILE "tests.txt"
-#        endif // !bTESTS_LOG_FILE
-#    endif     // !bTEST_NO_LOG
+            /// @brief starts counting hardware events for a benchmark loop on the calling thread (if "--counters" was
+            /// given)
+            void begin_loop_counters() noexcept;
 
-namespace
-{
-    //--Implementation Types--------------------------------------------------------------------------------------------
+            /// @brief stops counting hardware events for a benchmark loop on the calling thread
+            void end_loop_counters() noexcept;
+        } // namespace detail
 
-    /// @brief possible return values for the program-- either all the tests passed or at least one test failed!
-    enum struct ReturnValue : int
-    {
-        pass = 0,  ///< all tests passed!
-        fail = -1, ///< at least one test failed
-    };
+        /// @brief the exception thrown when an assertion fails
+        /// @note only holds pointers to string literals (the file name, and the text of the expression), so it can be
+        /// thrown (and caught) without allocating anything
+        class AssertionFailure : public std::exception
+        {
+          public:
+            /// @brief creates an assertion failure for a given location
+            /// @param file the name of the file containing the assertion (must outlive the exception)
+            /// @param line the line of the assertion
+            /// @param expression the text of the expression which was false (must outlive the exception)
+            AssertionFailure(const char *file, unsigned line, const char *expression) noexcept
+                : m_file{file}, m_line{line}, m_expression{expression} {};
 
-    //--Implementation Variables----------------------------------------------------------------------------------------
+            /// @brief gets the text of the expression which was false
+            /// @return the text of the expression
+            const char *what() const noexcept override { return m_expression; }
 
-    // we only need the log file variable if we're making use of the log file
-#    ifndef bTESTS_NO_LOG
-    /// @brief the output (logging) file stream
-    static std::ofstream g_testsLog{bTESTS_LOG_FILE};
-#    endif // !bTESTS_NO_LOG
+            /// @brief gets the name of the file containing the assertion
+            /// @return the file name (without any directories)
+            const char *file() const noexcept { return m_file; }
 
-    /// @brief keep track of the number of successes; incremeneted whenever a test passes
-    static size_t g_successes{0};
+            /// @brief gets the line of the assertion
+            /// @return the line number
+            unsigned line() const noexcept { return m_line; }
 
-    //--Implementation Methods------------------------------------------------------------------------------------------
+            /// @brief gets the text of the expression which was false
+            /// @return the text of the expression
+            const char *expression() const noexcept { return m_expression; }
 
-    /// @brief gets the unordered map of strings (group names) to unordered map of strings (function names) to test
-    /// function pointers to evaluate
-    /// @return the (static) unordered map of (group) strings to unordered maps of (function name) string identifiers to
-    /// test function pointers
-    /// @remark accessed through a "static getter" to avoid static initialization order problems!
-    std::unordered_map<std::string, std::unordered_map<std::string, ben::tests::bTestFnType>> &get_tests()
-    {
-        // store as a static variable in this function, return a reference to it
-        static std::unordered_map<std::string, std::unordered_map<std::string, ben::tests::bTestFnType>> s_tests;
-        return s_tests;
-    };
+          private:
+            const char *m_file;
+            unsigned    m_line;
+            const char *m_expression;
+        };
 
-    /// @brief convenience function; prints an 80 char long dashed line to the output
-    void print_line_separator()
-    {
-        std::cout << "--------------------------------------------------------------------------------\n";
-    };
+        class Benchmark;
 
-    /// @brief gets the total number of tests as the sum of all test counts per group
-    /// @return the total number of tests
-    const size_t get_number_of_tests()
-    {
-        static bool   first{true};
-        static size_t numTests{0};
+        /// @brief the type of function to use as a benchmark function within the framework
+        using bBenchmarkFnType = void (*)(Benchmark &);
 
-        if (first)
+        /// @brief the state of a benchmark; the benchmark function loops over it to run the code being measured
+        ///
+        /// the clock is started when the loop begins and stopped when the loop ends, so any setup before (or cleanup
+        /// after) the loop is not measured
+        class Benchmark
         {
-            for (const auto &[group, tests] : get_tests())
+          public:
+            /// @brief the (empty) value produced by each iteration of the loop
+            /// @note marked as maybe unused so that "for (auto _ : state)" doesn't produce a warning
+            struct [[maybe_unused]] Iteration
             {
-                numTests += tests.size();
-            }
-            first = false;
-        }
-        return numTests;
-    }
+            };
 
-    /// @brief prints information regarding the tests which are about to be performed as well as what the return value
-    /// of the program indicates
-    void print_info()
-    {
-        print_line_separator();
-        std::cout << "INFO:\tIf all tests pass (or no tests fail), the program will return success."
-                     "\n\t\tOtherwise, it will return failure.\n";
-        std::cout << "INFO:\tFound " << get_number_of_tests() << " test" << (get_number_of_tests() == 1 ? "" : "s")
-                  << " in " << get_tests().size() << " group" << (get_tests().size() == 1 ? ".\n" : "s.\n");
-        print_line_separator();
-    }
+            /// @brief counts down the iterations of a benchmark loop, stopping the clock when it reaches the end
+            class Iterator
+            {
+              public:
+                /// @brief creates an iterator with the given number of iterations remaining
+                /// @param benchmark the benchmark being iterated over
+                /// @param remaining the number of iterations remaining
+                Iterator(Benchmark *benchmark, size_t remaining) : m_benchmark{benchmark}, m_remaining{remaining} {};
 
-    /// @brief actually evaluate the tests
-    void run_tests()
-    {
-        size_t idx{0};
+                /// @brief gets the (empty) value for this iteration
+                /// @return an empty value
+                Iteration operator*() const { return Iteration{}; }
 
-        // save a pointer to the original std::cout buffer...
-        std::streambuf *const coutBuffer{std::cout.rdbuf()};
+                /// @brief moves on to the next iteration
+                /// @return this iterator
+                Iterator &operator++()
+                {
+                    m_remaining--;
+                    return *this;
+                }
 
-        std::cout << "RUNNING TESTS...\n";
+                /// @brief checks whether there are iterations remaining (stopping the clock if there are not)
+                /// @return true if there are iterations remaining
+                bool operator!=(const Iterator &) const
+                {
+                    if (m_remaining != 0)
+                    {
+                        return true;
+                    }
+                    m_benchmark->m_elapsed = std::chrono::steady_clock::now() - m_benchmark->m_start;
+                    detail::end_loop_counters();
+                    return false;
+                }
 
-        // walk through each group, getting the tests associated with that group
-        for (const auto &[group, tests] : get_tests())
-        {
-            // announce which group we're running
-            std::cout << "Group: '" << group << "'\n";
-#    ifndef bTESTS_NO_LOG
-            // set the std::cout's rdbuf to the output file stream...
-            std::cout.set_rdbuf(g_testsLog.rdbuf());
-            std::cout << "Group: '" << group << "'\n";
-            // and switch std::cout's rdbuf back to the old value!
-            std::cout.set_rdbuf(coutBuffer);
-#    endif // !bTESTS_NO_LOG
-           // walk through all of the tests and run them:
-            for (const auto &[name, test] : tests)
+              private:
+                Benchmark *m_benchmark;
+                size_t     m_remaining;
+            };
+
+            /// @brief creates the state for a benchmark run of a given number of iterations
+            /// @param iterations the number of times the loop should run
+            explicit Benchmark(size_t iterations) : m_iterations{iterations} {};
+
+            /// @brief starts the clock and begins the loop
+            /// @return an iterator to the first iteration
+            Iterator begin()
             {
-                // announce which test we're running
-                std::cout << "\t[" << (idx + 1) << "] : '" << name << "' ";
+                m_started = true;
+                detail::begin_loop_counters();
+                m_start = std::chrono::steady_clock::now();
+                return Iterator{this, m_iterations};
+            }
 
-                // it's feasible the function might try to print to std::cout... but we're printing the result
-                // (pass/fail) of the test there. We don't want to pollute the output too much! Instead, we can print
-                // the output from each test to a log file (along with a "header" for each test to separate the output
-                // of each test). We can switch the target buffer for std::cout to be a file so that anything that is
-                // printed to std::cout can be found in the file
-                //
-                // all that being said, we can skip the logging to a file if the bTESTS_NO_LOG preprocessor macro is
-                // defined
+            /// @brief gets the end of the loop
+            /// @return an iterator with no iterations remaining
+            Iterator end() { return Iterator{this, 0}; }
 
-#    ifndef bTESTS_NO_LOG
-                // set the std::cout's rdbuf to the output file stream...
-                std::cout.set_rdbuf(g_testsLog.rdbuf());
-                // announce which test we're running (now in the log file)
-                print_line_separator();
-                std::cout << "Test '" << name << "' log:\n\n";
+            /// @brief gets the number of times the loop runs
+            /// @return the number of iterations
+            size_t iterations() const { return m_iterations; }
+
+            /// @brief checks whether the benchmark function actually looped over the state
+            /// @return true if the loop was started
+            bool started() const { return m_started; }
+
+            /// @brief gets the time taken by the loop
+            /// @return the elapsed time (only meaningful once the loop has finished)
+            std::chrono::steady_clock::duration elapsed() const { return m_elapsed; }
+
+          private:
+            size_t                                m_iterations;
+            bool                                  m_started{false};
+            std::chrono::steady_clock::time_point m_start{};
+            std::chrono::steady_clock::duration   m_elapsed{};
+        };
+
+        namespace detail
+        {
+            /// @brief does nothing with a pointer, but is defined in the implementation so the compiler can't see that
+            /// @param pointer the pointer to (not) use
+            void use_pointer(const volatile void *pointer);
+        } // namespace detail
+
+        /// @brief prevents the compiler from optimizing away the computation of a value in a benchmark
+        /// @param value the value which must be computed
+        template <typename T>
+        inline void do_not_optimize(const T &value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void *))
+            {
+                asm volatile("" : : "r,m"(value) : "memory");
+            }
+            else
+            {
+                asm volatile("" : : "m"(value) : "memory");
+            }
+#else
+            detail::use_pointer(&value);
+            _ReadWriteBarrier();
+#endif // __GNUC__ || __clang__
+        }
+
+        /// @brief prevents the compiler from optimizing away (or reordering) writes to memory in a benchmark
+        inline void clobber_memory()
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : : "memory");
+#else
+            _ReadWriteBarrier();
+#endif // __GNUC__ || __clang__
+        }
+
+        namespace detail
+        {
+            /// @brief how widely a fixture is shared
+            enum struct FixtureScope : int
+            {
+                suite  = 0, ///< one fixture for the whole run
+                group  = 1, ///< one fixture per group (of the test which asks for it)
+                thread = 2, ///< one fixture per group and per thread
+            };
+
+            /// @brief a variable whose address identifies a fixture type (without needing RTTI)
+            template <typename T>
+            inline constexpr char g_fixtureType{};
+
+            /// @brief creates a (default constructed) fixture
+            /// @return a pointer to the new fixture
+            template <typename T>
+            void *create_fixture()
+            {
+                return new T();
+            }
+
+            /// @brief destroys a fixture made by create_fixture
+            /// @param fixture the fixture to destroy
+            template <typename T>
+            void destroy_fixture(void *fixture)
+            {
+                delete static_cast<T *>(fixture);
+            }
+
+            /// @brief gets a fixture, creating it the first time it's asked for (in its scope)
+            /// @param scope how widely the fixture is shared
+            /// @param type identifies the type of the fixture
+            /// @param create creates the fixture
+            /// @param destroy destroys the fixture (when its scope ends)
+            /// @return a pointer to the fixture
+            void *get_fixture(FixtureScope scope, const void *type, void *(*create)(), void (*destroy)(void *));
+        } // namespace detail
+
+        /// @brief gets a fixture which is shared by every test in the run
+        ///
+        /// the fixture is default constructed the first time any test asks for it and destroyed after the last test
+        /// (and benchmark) has run. It may be used from several threads at once (in parallel runs), so it is const
+        ///
+        /// @return a reference to the fixture
+        template <typename T>
+        const T &suite_fixture()
+        {
+            return *static_cast<const T *>(detail::get_fixture(
+                detail::FixtureScope::suite, &detail::g_fixtureType<T>, &detail::create_fixture<T>,
+                &detail::destroy_fixture<T>));
+        }
+
+        /// @brief gets a fixture which is shared by every test in the group of the calling test
+        ///
+        /// the fixture is default constructed the first time a test in the group asks for it and destroyed once the
+        /// last test in the group has finished. It may be used from several threads at once (in parallel runs), so it
+        /// is const-- see thread_fixture() for one which can be modified
+        ///
+        /// @return a reference to the fixture
+        template <typename T>
+        const T &group_fixture()
+        {
+            return *static_cast<const T *>(detail::get_fixture(
+                detail::FixtureScope::group, &detail::g_fixtureType<T>, &detail::create_fixture<T>,
+                &detail::destroy_fixture<T>));
+        }
+
+        /// @brief gets a fixture which is shared by the tests in the group of the calling test which run on the same
+        /// thread (so it's only used by one test at a time, and can be modified)
+        ///
+        /// each thread's copy is default constructed the first time one of the group's tests asks for it on that
+        /// thread, and destroyed once the last test in the group has finished
+        ///
+        /// @return a reference to the fixture
+        template <typename T>
+        T &thread_fixture()
+        {
+            return *static_cast<T *>(detail::get_fixture(
+                detail::FixtureScope::thread, &detail::g_fixtureType<T>, &detail::create_fixture<T>,
+                &detail::destroy_fixture<T>));
+        }
+
+        template <typename T>
+        class Task;
+
+        /// @brief the type of function to use as an async (coroutine) test function within the framework
+        using bAsyncFnType = Task<void> (*)();
+
+        namespace detail
+        {
+            /// @brief gets the async test whose coroutine is running on the calling thread
+            /// @return the (opaque, never reused) id of the test, or 0 if no async test is running on this thread
+            uint64_t &current_async_test() noexcept;
+
+            /// @brief resumes a coroutine of an async test on the event loop; may be called from any thread
+            /// @param test the id of the test the coroutine belongs to (see current_async_test()); nothing is resumed
+            /// if the test has already finished (or timed out)
+            /// @param handle the coroutine to resume
+            /// @param delayNs how long to wait (in nanoseconds) before resuming it
+            void post_to_loop(uint64_t test, std::coroutine_handle<> handle, long long delayNs = 0);
+
+            /// @brief the parts of the promise of a Task which don't depend on its value
+            class TaskPromiseBase
+            {
+              public:
+                /// @brief waits for the final suspend of a task, then resumes whatever was awaiting it (if anything)
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept
+                    {
+                        return false;
+                    }
+
+                    template <typename Promise>
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+                    {
+                        const std::coroutine_handle<> continuation{handle.promise().m_continuation};
+                        return (continuation ? continuation : std::noop_coroutine());
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+
+                /// @brief tasks are lazy; nothing runs until the task is awaited (or started by the runner)
+                std::suspend_always initial_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                /// @brief hands control back to whatever awaited the task
+                FinalAwaiter final_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                /// @brief keeps an exception (e.g. a failed assertion) to rethrow in whatever awaits the task
+                void unhandled_exception() noexcept
+                {
+#ifndef bTESTS_NO_EXCEPTIONS
+                    m_exception = std::current_exception();
+#else
+                    std::terminate();
+#endif // !bTESTS_NO_EXCEPTIONS
+                }
+
+                /// @brief rethrows the exception which escaped the task (if any)
+                void rethrow_if_failed() const
+                {
+#ifndef bTESTS_NO_EXCEPTIONS
+                    if (m_exception)
+                    {
+                        std::rethrow_exception(m_exception);
+                    }
+#endif // !bTESTS_NO_EXCEPTIONS
+                }
+
+                std::coroutine_handle<> m_continuation; ///< whatever is awaiting the task (null if nothing is)
+#ifndef bTESTS_NO_EXCEPTIONS
+                std::exception_ptr m_exception; ///< the exception which escaped the task (if any)
+#endif // !bTESTS_NO_EXCEPTIONS
+            };
+
+            /// @brief the part of the promise of a Task which holds its value
+            template <typename T>
+            class TaskValue
+            {
+              public:
+                /// @brief keeps the value the task returned
+                /// @param value the value
+                template <typename U>
+                void return_value(U &&value)
+                {
+                    m_value.emplace(std::forward<U>(value));
+                }
+
+                /// @brief takes the value the task returned
+                /// @return the value
+                T take_value()
+                {
+                    return std::move(*m_value);
+                }
+
+              private:
+                std::optional<T> m_value; ///< the value (empty until the task returns)
+            };
+
+            /// @brief the part of the promise of a Task which holds its value (of which there's none)
+            template <>
+            class TaskValue<void>
+            {
+              public:
+                void return_void() const noexcept {}
+
+                void take_value() const noexcept {}
+            };
+        } // namespace detail
+
+        /// @brief a (lazily started) coroutine: the return type of async tests (see bTEST_ASYNC), and of any coroutines
+        /// they await
+        ///
+        /// awaiting a task runs it (on the same thread) until it finishes, then resumes the awaiting coroutine with its
+        /// value-- or rethrows whatever escaped it, so a failed assertion fails the test just like it would in a
+        /// normal function
+        ///
+        /// @tparam T the type of the value the coroutine returns (void for none)
+        template <typename T = void>
+        class [[nodiscard]] Task
+        {
+          public:
+            /// @brief the promise of the coroutine
+            struct promise_type : detail::TaskPromiseBase, detail::TaskValue<T>
+            {
+                /// @brief makes the task which owns the coroutine
+                Task get_return_object() noexcept
+                {
+                    return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+            };
+
+            /// @brief takes ownership of a coroutine
+            /// @param handle the coroutine
+            explicit Task(std::coroutine_handle<promise_type> handle) noexcept : m_handle{handle} {}
+
+            Task(Task &&other) noexcept : m_handle{std::exchange(other.m_handle, nullptr)} {}
+            Task &operator=(Task &&other) noexcept
+            {
+                std::swap(m_handle, other.m_handle);
+                return *this;
+            }
+            Task(const Task &)            = delete;
+            Task &operator=(const Task &) = delete;
+
+            /// @brief destroys the coroutine (which must be finished, or never started)
+            ~Task()
+            {
+                if (m_handle)
+                {
+                    m_handle.destroy();
+                }
+            }
+
+            /// @brief tasks are never ready until they've run
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            /// @brief runs the task (straight away, on this thread), resuming the awaiting coroutine once it finishes
+            /// @param awaiting the coroutine awaiting the task
+            /// @return the task's coroutine (to resume in place of the awaiting one)
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                m_handle.promise().m_continuation = awaiting;
+                return m_handle;
+            }
+
+            /// @brief gets the value of the finished task (rethrowing whatever escaped it, if anything)
+            /// @return the value
+            T await_resume()
+            {
+                m_handle.promise().rethrow_if_failed();
+                return m_handle.promise().take_value();
+            }
+
+            /// @brief gets the coroutine (without giving up ownership of it); used by the runner to start the test
+            /// @return the coroutine
+            std::coroutine_handle<promise_type> get_handle() const noexcept
+            {
+                return m_handle;
+            }
+
+          private:
+            std::coroutine_handle<promise_type> m_handle; ///< the coroutine
+        };
+
+        /// @brief suspends an async test for (at least) a while, letting the other async tests run in the meantime
+        ///
+        ///     co_await ben::tests::sleep_for(std::chrono::milliseconds{10});
+        ///
+        /// @param duration how long to sleep for
+        /// @return the awaitable
+        template <typename Rep, typename Period>
+        auto sleep_for(std::chrono::duration<Rep, Period> duration) noexcept
+        {
+            struct SleepAwaiter
+            {
+                long long delayNs; ///< how long to sleep for (in nanoseconds)
+
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) const
+                {
+                    detail::post_to_loop(detail::current_async_test(), handle, delayNs);
+                }
+
+                void await_resume() const noexcept {}
+            };
+            return SleepAwaiter{std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()};
+        }
+
+        /// @brief a one-shot event which an async test can await, and which anything (e.g. the completion callback of
+        /// some asynchronous I/O, on any thread) can set-- which resumes the test on the event loop
+        ///
+        ///     ben::tests::AsyncEvent connected;
+        ///     client.async_connect(address, [&connected](auto) { connected.set(); });
+        ///     co_await connected;
+        ///
+        /// @note only one coroutine may await an event at a time; once set, awaiting the event never suspends
+        class AsyncEvent
+        {
+          public:
+            AsyncEvent() = default;
+
+            AsyncEvent(const AsyncEvent &)            = delete;
+            AsyncEvent &operator=(const AsyncEvent &) = delete;
+
+            /// @brief sets the event, resuming the coroutine awaiting it (if any) on the event loop
+            /// @note posting the resume may start the loop's threads and allocate, so this may throw std::system_error
+            /// or std::bad_alloc (after the event is set, but with the coroutine left suspended)
+            void set()
+            {
+                void *const waiter{m_state.exchange(this, std::memory_order_acq_rel)};
+                if (waiter != nullptr && waiter != this)
+                {
+                    const Waiter &resume{*static_cast<Waiter *>(waiter)};
+                    detail::post_to_loop(resume.test, resume.handle);
+                }
+            }
+
+            /// @brief checks whether the event has been set
+            /// @return true if it has
+            bool is_set() const noexcept
+            {
+                return m_state.load(std::memory_order_acquire) == this;
+            }
+
+            /// @brief waits for the event to be set
+            auto operator co_await() noexcept
+            {
+                struct Awaiter
+                {
+                    AsyncEvent &event;  ///< the event being awaited
+                    Waiter      waiter; ///< the coroutine to resume once it's set (lives in the coroutine's frame)
+
+                    bool await_ready() const noexcept
+                    {
+                        return event.is_set();
+                    }
+
+                    bool await_suspend(std::coroutine_handle<> handle) noexcept
+                    {
+                        // if the event is set in the meantime, carry straight on instead
+                        waiter = Waiter{detail::current_async_test(), handle};
+                        void *expected{nullptr};
+                        return event.m_state.compare_exchange_strong(expected, &waiter, std::memory_order_acq_rel);
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+                return Awaiter{*this, {}};
+            }
+
+          private:
+            /// @brief a coroutine waiting for the event
+            struct Waiter
+            {
+                uint64_t                test{0}; ///< the id of the async test the coroutine belongs to
+                std::coroutine_handle<> handle;  ///< the coroutine
+            };
+
+            std::atomic<void *> m_state{nullptr}; ///< nullptr, the waiting Waiter, or this (once the event is set)
+        };
+
+        namespace detail
+        {
+            /// @brief a registered test (or benchmark); bTEST_REGISTER makes one constant per test, with no class or
+            /// object per test
+            ///
+            /// with bTESTS_USE_LINKER_SECTION, a pointer to each registration is placed in the "bTESTS_registrations"
+            /// linker section, which the linker gathers into one table. Otherwise a Registrar copies it onto an
+            /// intrusive (singly) linked list during static initialization; the single table object of a
+            /// parameterized test links all of its cases there itself, and only tests registered by hand (through the
+            /// UnitTest fallback) keep their registration inside a UnitTest. Either way, registering a test never
+            /// allocates, and the names point straight at the string literals from the macros
+            struct Registration
+            {
+                const char        *name{nullptr};      ///< the name of the test
+                const char        *group{nullptr};     ///< the name of the group the test belongs to
+                bTestFnType        test{nullptr};      ///< the function which implements the test (if it's a test)
+                bBenchmarkFnType   benchmark{nullptr}; ///< the function which implements the benchmark (if it's one)
+                const char        *attributes{nullptr}; ///< the attributes of the test ("key=value" pairs)
+                const Registration *next{nullptr};     ///< the previously registered test
+                unsigned long long  fingerprint{0};    ///< identifies the build of the test's source (0 if unknown)
+                bAsyncFnType        asyncTest{nullptr}; ///< the coroutine which implements the test (if it's async)
+            };
+
+            /// @brief the most recently registered test (the head of the list of registrations)
+            /// @note constant initialized, so it is safe to use during static initialization
+            inline const Registration *g_registrations{nullptr};
+
+            /// @brief hashes the file name and build id of a translation unit (see bTESTS_FINGERPRINT)
+            /// @param text the text to hash
+            /// @return the (64-bit FNV-1a) hash of the text; never 0, which means the fingerprint isn't known
+            constexpr unsigned long long get_fingerprint(const char *text)
+            {
+                unsigned long long hash{14695981039346656037ull};
+                for (; *text != '\0'; text++)
+                {
+                    hash = ((hash ^ static_cast<unsigned char>(*text)) * 1099511628211ull) & 0xFFFFFFFFFFFFFFFFull;
+                }
+                return (hash == 0 ? 1 : hash);
+            }
+
+            /// @brief makes the registration of a test (used by bTEST_REGISTER)
+            /// @param fingerprint the fingerprint of the test's translation unit (see bTESTS_FINGERPRINT)
+            /// @param name the name of the test
+            /// @param test the function which implements the test
+            /// @param group the name of the group the test belongs to
+            /// @param attributes the attributes of the test (comma separated "key=value" pairs, e.g. "timeout=5")
+            /// @return the registration (which isn't in the list of registrations yet)
+            constexpr Registration make_registration(
+                unsigned long long fingerprint,
+                const char        *name,
+                bTestFnType        test,
+                const char        *group      = "ungrouped",
+                const char        *attributes = "")
+            {
+                return Registration{name, group, test, nullptr, attributes, nullptr, fingerprint};
+            }
+
+            /// @brief makes the registration of a benchmark (used by bTEST_REGISTER)
+            /// @param fingerprint the fingerprint of the benchmark's translation unit (see bTESTS_FINGERPRINT)
+            /// @param name the name of the benchmark
+            /// @param benchmark the function which implements the benchmark
+            /// @param group the name of the group the benchmark belongs to
+            /// @param attributes the attributes of the benchmark (just like a test's)
+            /// @return the registration (which isn't in the list of registrations yet)
+            constexpr Registration make_registration(
+                unsigned long long fingerprint,
+                const char        *name,
+                bBenchmarkFnType   benchmark,
+                const char        *group      = "ungrouped",
+                const char        *attributes = "")
+            {
+                return Registration{name, group, nullptr, benchmark, attributes, nullptr, fingerprint};
+            }
+
+            /// @brief makes the registration of an async test (used by bTEST_REGISTER)
+            /// @param fingerprint the fingerprint of the test's translation unit (see bTESTS_FINGERPRINT)
+            /// @param name the name of the test
+            /// @param asyncTest the coroutine which implements the test
+            /// @param group the name of the group the test belongs to
+            /// @param attributes the attributes of the test (just like bTEST_FUNCTION's)
+            /// @return the registration (which isn't in the list of registrations yet)
+            constexpr Registration make_registration(
+                unsigned long long fingerprint,
+                const char        *name,
+                bAsyncFnType       asyncTest,
+                const char        *group      = "ungrouped",
+                const char        *attributes = "")
+            {
+                return Registration{name, group, nullptr, nullptr, attributes, nullptr, fingerprint, asyncTest};
+            }
+
+            /// @brief pushes a registration onto the front of the list of registrations when it's constructed (where
+            /// tests can't be registered through a linker section, see bTEST_REGISTER)
+            class Registrar
+            {
+              public:
+                /// @brief registers a test
+                /// @param registration the registration of the test
+                explicit Registrar(const Registration &registration) : m_registration{registration}
+                {
+                    m_registration.next = g_registrations;
+                    g_registrations     = &m_registration;
+                }
+
+                // the list of registrations points into this object, so it can't be copied or moved
+                Registrar(const Registrar &)            = delete;
+                Registrar &operator=(const Registrar &) = delete;
+
+              private:
+                Registration m_registration; ///< this test's entry in the list of registrations
+            };
+        } // namespace detail
+
+        /// @brief a struct which represents a unit test
+        /// @note this is intentionally "empty" (aside from a custom ctor and its registration) because the way the
+        /// unit testing framework implements tests is by inheriting from this (very basic) struct for each test to be
+        /// implemented. The ctors of the specific tests provide the arguments for this ctor, so the macro to create
+        /// each individual test can (indirectly) provide a name and a function to this ctor and everything plays nicely
+        struct UnitTest
+        {
+          protected:
+            /// @brief accepts a name for the unit test (a c str) and a pointer to the function which implements the
+            /// test
+            /// @param name the name of the test (not necessarily the name of the function)
+            /// @param func a pointer to a bTestFunc_t (a function which takes no arguments and returns nothing) which
+            /// houses the test implementation
+            /// @param group the name of the group the test belongs to
+            /// @param attributes the attributes of the test (comma separated "key=value" pairs, e.g. "timeout=5")
+            UnitTest(const char *name, bTestFnType func, const char *group = "ungrouped", const char *attributes = "");
+
+            /// @brief accepts a name for a benchmark (a c str) and a pointer to the function which implements it
+            /// @param name the name of the benchmark (not necessarily the name of the function)
+            /// @param func a pointer to a bBenchmarkFnType which houses the benchmark implementation
+            /// @param group the name of the group the benchmark belongs to
+            /// @param attributes the attributes of the benchmark (just like a test's)
+            UnitTest(
+                const char      *name,
+                bBenchmarkFnType func,
+                const char      *group      = "ungrouped",
+                const char      *attributes = "");
+
+            // we do NOT want to be able to copy/move/assign unit tests (that's nonsensical)
+            UnitTest()                                = delete;
+            UnitTest(const UnitTest &)                = delete;
+            UnitTest(UnitTest &&) noexcept            = delete;
+            UnitTest &operator=(const UnitTest &)     = delete;
+            UnitTest &operator=(UnitTest &&) noexcept = delete;
+
+          public:
+            /// @brief dtor is virtual since unit tests are to be inherited from
+            virtual ~UnitTest() = default;
+
+          private:
+            /// @brief this test's entry in the list of registrations
+            detail::Registration m_registration;
+        };
+
+        namespace detail
+        {
+            /// @brief registers the cases of a parameterized test (see bTEST_PARAMETERIZED)
+            ///
+            /// each case gets its own (compile time generated) test function, which calls the body with one of the
+            /// values, and its own registration-- all of which live in this one object
+            ///
+            /// @tparam Values the values of the cases (a std::array with static storage duration)
+            /// @tparam Body the function which implements the test, called with each of the values
+            template <const auto &Values, auto Body>
+            class ParameterizedTest
+            {
+              public:
+                /// @brief registers every case of the test
+                /// @param fingerprint the fingerprint of the test's translation unit (see bTESTS_FINGERPRINT)
+                /// @param name the name of the test; the cases are named "name[index]" (the index padded with zeros,
+                /// so the cases are listed in order)
+                /// @param group the name of the group the cases belong to
+                /// @param attributes the attributes of every case (just like bTEST_FUNCTION's)
+                ParameterizedTest(
+                    unsigned long long fingerprint,
+                    const char        *name,
+                    const char        *group      = "ungrouped",
+                    const char        *attributes = "")
+                {
+                    const size_t width{std::to_string(s_count > 0 ? s_count - 1 : 0).size()};
+                    const std::array<bTestFnType, s_count> functions{
+                        get_functions(std::make_index_sequence<s_count>{})};
+                    for (size_t idx{0}; idx < s_count; idx++)
+                    {
+                        const std::string index{std::to_string(idx)};
+                        m_names[idx].assign(name).append("[").append(width - index.size(), '0');
+                        m_names[idx].append(index).append("]");
+
+                        m_registrations[idx] =
+                            Registration{m_names[idx].c_str(), group, functions[idx], nullptr, attributes,
+                                         g_registrations, fingerprint};
+                        g_registrations = &m_registrations[idx];
+                    }
+                }
+
+                // the registrations point into this object, so it can't be copied or moved
+                ParameterizedTest(const ParameterizedTest &)            = delete;
+                ParameterizedTest &operator=(const ParameterizedTest &) = delete;
+
+              private:
+                /// @brief the number of cases
+                static constexpr size_t s_count{std::tuple_size_v<std::remove_cv_t<std::remove_reference_t<
+                    decltype(Values)>>>};
+
+                /// @brief runs one of the cases
+                template <size_t Index>
+                static void run_case()
+                {
+                    Body(Values[Index]);
+                }
+
+                /// @brief gets the functions which run each of the cases
+                /// @return the functions, in the order of the values
+                template <size_t... Indices>
+                static constexpr std::array<bTestFnType, s_count> get_functions(std::index_sequence<Indices...>)
+                {
+                    return {&run_case<Indices>...};
+                }
+
+                std::array<std::string, s_count>  m_names{};         ///< the names of the cases
+                std::array<Registration, s_count> m_registrations{}; ///< the registrations of the cases
+            };
+        } // namespace detail
+
+        /// @brief a fast (allocation free) source of random numbers for property tests (see bTEST_PROPERTY)
+        ///
+        /// either a splitmix64 sequence started from a seed or, when fuzzing, the bytes of the fuzzer's input-- which
+        /// are followed by zeros once they run out, so a short input generates small values
+        class Random
+        {
+          public:
+            /// @brief starts a sequence of random numbers from a seed
+            /// @param seed the seed (the same seed always gives the same numbers, on every platform)
+            explicit constexpr Random(uint64_t seed) : m_state{seed} {}
+
+            /// @brief draws the numbers from a buffer of bytes (e.g. a fuzzer's input) instead
+            /// @param data the bytes (which must outlive this object)
+            /// @param size the number of bytes
+            constexpr Random(const unsigned char *data, size_t size) : m_data{data}, m_size{size} {}
+
+            /// @brief gets the next random number
+            /// @return the number (any 64-bit value)
+            constexpr uint64_t next()
+            {
+                if (m_data != nullptr)
+                {
+                    uint64_t value{0};
+                    for (size_t idx{0}; idx < sizeof(value) && m_size > 0; idx++, m_size--)
+                    {
+                        value = (value << 8) | *m_data++;
+                    }
+                    return value;
+                }
+
+                uint64_t mixed{m_state += 0x9E3779B97F4A7C15ull};
+                mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+                mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+                return mixed ^ (mixed >> 31);
+            }
+
+            /// @brief gets a random number below a bound
+            /// @param bound the bound
+            /// @return a number in [0, bound), or 0 if the bound is 0
+            constexpr uint64_t below(uint64_t bound)
+            {
+                return (bound == 0 ? 0 : next() % bound);
+            }
+
+          private:
+            uint64_t             m_state{0};     ///< the state of the sequence (if not drawing from a buffer)
+            const unsigned char *m_data{nullptr}; ///< the bytes left to draw from (nullptr to use the sequence)
+            size_t               m_size{0};      ///< how many bytes are left
+        };
+
+        /// @brief the generators of the inputs of property tests (see bTEST_PROPERTY)
+        ///
+        /// a generator has a value_type, and two (const) members: generate(random, size, value), which overwrites
+        /// value with a random one (reusing its storage, so generating thousands of inputs allocates very little),
+        /// where size grows from 0 to 100 over the cases of a test; and shrink(value, candidates), which appends
+        /// "simpler" values to try when value fails the property (none if it can't be simplified)
+        namespace gen
+        {
+            /// @brief generates integers in a range, around 0 (or the bound closest to it) for small sizes, with an
+            /// occasional edge case (the bounds); shrinks towards 0 (or the bound closest to it)
+            /// @tparam T the type of integer
+            template <typename T>
+            struct integers
+            {
+                static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "use gen::booleans for bools");
+
+                using value_type = T; ///< the type of the values generated
+
+                T min{std::numeric_limits<T>::min()}; ///< the smallest value to generate
+                T max{std::numeric_limits<T>::max()}; ///< the largest value to generate
+
+                /// @brief generates any value of the type
+                constexpr integers() = default;
+
+                /// @brief generates values in a range
+                /// @param minimum the smallest value to generate
+                /// @param maximum the largest value to generate
+                constexpr integers(T minimum, T maximum) : min{minimum}, max{maximum} {}
+
+                /// @brief generates a value
+                /// @param random the source of random numbers
+                /// @param size how "big" the value may be (from 0 to 100)
+                /// @param value set to the generated value
+                constexpr void generate(Random &random, size_t size, T &value) const
+                {
+                    const uint64_t choice{random.below(16)};
+                    if (choice < 2)
+                    {
+                        value = (choice == 0 ? min : max);
+                        return;
+                    }
+
+                    // the range grows (exponentially) with the size, out from the origin
+                    const size_t   bits{std::min<size_t>(2 + size * 62 / 100, 64)};
+                    const uint64_t magnitude{bits >= 64 ? random.next() : random.next() & ((1ull << bits) - 1)};
+                    const uint64_t origin{to_ordered(get_origin())};
+                    if ((random.next() & 1) != 0)
+                    {
+                        value = from_ordered(origin - std::min(magnitude, origin - to_ordered(min)));
+                    }
+                    else
+                    {
+                        value = from_ordered(origin + std::min(magnitude, to_ordered(max) - origin));
+                    }
+                }
+
+                /// @brief gets simpler values to try in place of a failing one
+                /// @param value the failing value
+                /// @param candidates the simpler values are appended to this (the simplest first)
+                void shrink(const T &value, std::vector<T> &candidates) const
+                {
+                    const uint64_t origin{to_ordered(get_origin())};
+                    const uint64_t current{to_ordered(value)};
+                    candidates.push_back(get_origin());
+                    for (uint64_t step{(current > origin ? current - origin : origin - current) / 2}; step > 0;
+                         step /= 2)
+                    {
+                        candidates.push_back(from_ordered(current > origin ? current - step : current + step));
+                    }
+                    if (current != origin)
+                    {
+                        candidates.push_back(from_ordered(current > origin ? current - 1 : current + 1));
+                    }
+                }
+
+              private:
+                /// @brief gets the value the generated values are centred on (and shrink towards)
+                /// @return 0, or the bound closest to it if 0 is out of range
+                constexpr T get_origin() const
+                {
+                    return (min > 0 ? min : (max < 0 ? max : T{0}));
+                }
+
+                /// @brief maps a value onto an unsigned integer with the same order (so distances can't overflow)
+                static constexpr uint64_t to_ordered(T value)
+                {
+                    if constexpr (std::is_signed_v<T>)
+                    {
+                        return static_cast<uint64_t>(static_cast<int64_t>(value)) ^ (1ull << 63);
+                    }
+                    else
+                    {
+                        return static_cast<uint64_t>(value);
+                    }
+                }
+
+                /// @brief the inverse of to_ordered
+                static constexpr T from_ordered(uint64_t ordered)
+                {
+                    if constexpr (std::is_signed_v<T>)
+                    {
+                        return static_cast<T>(static_cast<int64_t>(ordered ^ (1ull << 63)));
+                    }
+                    else
+                    {
+                        return static_cast<T>(ordered);
+                    }
+                }
+            };
+
+            /// @brief generates floating point numbers in a range (never NaN or infinite), whose magnitude grows with
+            /// the size, with an occasional edge case (0, the bounds, ±1, and the smallest normal values); shrinks
+            /// towards 0 (or the bound closest to it), and towards whole numbers
+            /// @tparam T the type of floating point number
+            template <typename T>
+            struct reals
+            {
+                static_assert(std::is_floating_point_v<T>, "gen::reals generates floating point numbers");
+
+                using value_type = T; ///< the type of the values generated
+
+                T min{std::numeric_limits<T>::lowest()}; ///< the smallest value to generate
+                T max{std::numeric_limits<T>::max()};    ///< the largest value to generate
+
+                /// @brief generates any (finite) value of the type
+                constexpr reals() = default;
+
+                /// @brief generates values in a range
+                /// @param minimum the smallest value to generate
+                /// @param maximum the largest value to generate
+                constexpr reals(T minimum, T maximum) : min{minimum}, max{maximum} {}
+
+                /// @brief generates a value
+                /// @param random the source of random numbers
+                /// @param size how "big" the value may be (from 0 to 100)
+                /// @param value set to the generated value
+                constexpr void generate(Random &random, size_t size, T &value) const
+                {
+                    constexpr T edges[]{T{0}, T{1}, T{-1}, std::numeric_limits<T>::min(),
+                                        -std::numeric_limits<T>::min()};
+                    const uint64_t choice{random.below(16)};
+                    if (choice < 2)
+                    {
+                        value = (choice == 0 ? min : max);
+                        return;
+                    }
+                    if (choice < 2 + std::size(edges))
+                    {
+                        value = clamp(edges[choice - 2]);
+                        return;
+                    }
+
+                    // a fraction in [-1, 1), scaled by 2^(size / 2)
+                    T scale{1};
+                    for (size_t idx{0}; idx < size / 2; idx++)
+                    {
+                        scale *= T{2};
+                    }
+                    const T fraction{static_cast<T>(static_cast<double>(random.next() >> 11) * 0x1.0p-52 - 1.0)};
+                    value = clamp(get_origin() + fraction * scale);
+                }
+
+                /// @brief gets simpler values to try in place of a failing one
+                /// @param value the failing value
+                /// @param candidates the simpler values are appended to this (the simplest first)
+                void shrink(const T &value, std::vector<T> &candidates) const
+                {
+                    const T origin{get_origin()};
+                    if (value == origin)
+                    {
+                        return;
+                    }
+                    candidates.push_back(origin);
+                    const T whole{clamp(static_cast<T>(static_cast<long long>(value)))};
+                    if (whole != value && value > T{-9e18} && value < T{9e18})
+                    {
+                        candidates.push_back(whole);
+                    }
+
+                    // move towards the origin, by the largest fraction of the distance first
+                    constexpr T fractions[]{T{0x1.0p-64}, T{0x1.0p-32}, T{0x1.0p-16}, T{0x1.0p-8},
+                                            T{0x1.0p-4},  T{0x1.0p-2},  T{0x1.0p-1}};
+                    for (const T fraction : fractions)
+                    {
+                        candidates.push_back(clamp(origin + (value - origin) * fraction));
+                    }
+                }
+
+              private:
+                /// @brief gets the value the generated values are centred on (and shrink towards)
+                /// @return 0, or the bound closest to it if 0 is out of range
+                constexpr T get_origin() const
+                {
+                    return (min > T{0} ? min : (max < T{0} ? max : T{0}));
+                }
+
+                /// @brief clamps a value into the range
+                constexpr T clamp(T value) const
+                {
+                    return (value < min ? min : (value > max ? max : value));
+                }
+            };
+
+            /// @brief generates bools; shrinks true to false
+            struct booleans
+            {
+                using value_type = bool; ///< the type of the values generated
+
+                /// @brief generates a value
+                /// @param random the source of random numbers
+                /// @param value set to the generated value
+                constexpr void generate(Random &random, size_t, bool &value) const
+                {
+                    value = ((random.next() & 1) != 0);
+                }
+
+                /// @brief gets simpler values to try in place of a failing one
+                /// @param value the failing value
+                /// @param candidates false is appended to this if value is true
+                void shrink(bool value, std::vector<bool> &candidates) const
+                {
+                    if (value)
+                    {
+                        candidates.push_back(false);
+                    }
+                }
+            };
+
+            /// @brief generates strings (whose length grows with the size) of characters from an alphabet; shrinks by
+            /// removing characters, and by replacing them with the first character of the alphabet
+            struct strings
+            {
+                using value_type = std::string; ///< the type of the values generated
+
+                size_t      maxLength{32};       ///< the longest string to generate
+                const char *alphabet{nullptr};   ///< the characters to use (nullptr for printable ASCII)
+
+                /// @brief generates strings of printable ASCII characters
+                constexpr strings() = default;
+
+                /// @brief generates strings of up to a given length
+                /// @param maximumLength the longest string to generate
+                /// @param characters the characters to use (nullptr for printable ASCII; must not be empty)
+                constexpr explicit strings(size_t maximumLength, const char *characters = nullptr)
+                    : maxLength{maximumLength}, alphabet{characters}
+                {
+                }
+
+                /// @brief generates a value
+                /// @param random the source of random numbers
+                /// @param size how "big" the value may be (from 0 to 100)
+                /// @param value set to the generated value (reusing its storage)
+                void generate(Random &random, size_t size, std::string &value) const
+                {
+                    const size_t alphabetSize{get_alphabet_size()};
+                    value.resize(static_cast<size_t>(random.below(std::min(maxLength, size) + 1)));
+                    for (char &character : value)
+                    {
+                        const size_t idx{static_cast<size_t>(random.below(alphabetSize))};
+                        character = (alphabet == nullptr ? static_cast<char>(' ' + idx) : alphabet[idx]);
+                    }
+                }
+
+                /// @brief gets simpler values to try in place of a failing one
+                /// @param value the failing value
+                /// @param candidates the simpler values are appended to this (the simplest first)
+                void shrink(const std::string &value, std::vector<std::string> &candidates) const
+                {
+                    if (value.empty())
+                    {
+                        return;
+                    }
+                    candidates.emplace_back();
+                    if (value.size() > 1)
+                    {
+                        candidates.push_back(value.substr(0, value.size() / 2));
+                        candidates.push_back(value.substr(value.size() / 2));
+                    }
+                    for (size_t idx{0}; idx < value.size() && idx < 32; idx++)
+                    {
+                        candidates.push_back(std::string{value}.erase(idx, 1));
+                    }
+                    const char simplest{alphabet == nullptr ? 'a' : alphabet[0]};
+                    for (size_t idx{0}; idx < value.size() && idx < 32; idx++)
+                    {
+                        if (value[idx] != simplest)
+                        {
+                            candidates.push_back(value);
+                            candidates.back()[idx] = simplest;
+                        }
+                    }
+                }
+
+              private:
+                /// @brief gets the number of characters in the alphabet
+                constexpr size_t get_alphabet_size() const
+                {
+                    if (alphabet == nullptr)
+                    {
+                        return 95; // ' ' to '~'
+                    }
+                    size_t count{0};
+                    while (alphabet[count] != '\0')
+                    {
+                        count++;
+                    }
+                    return count;
+                }
+            };
+
+            /// @brief generates vectors (whose length grows with the size) of values from another generator; shrinks by
+            /// removing elements, and by shrinking them
+            /// @tparam Element the generator of the elements
+            template <typename Element>
+            struct vectors
+            {
+                using value_type = std::vector<typename Element::value_type>; ///< the type of the values generated
+
+                Element element;       ///< the generator of the elements
+                size_t  maxLength{32}; ///< the longest vector to generate
+
+                /// @brief generates vectors of up to a given length
+                /// @param elementGenerator the generator of the elements
+                /// @param maximumLength the longest vector to generate
+                constexpr explicit vectors(Element elementGenerator, size_t maximumLength = 32)
+                    : element{elementGenerator}, maxLength{maximumLength}
+                {
+                }
+
+                /// @brief generates a value
+                /// @param random the source of random numbers
+                /// @param size how "big" the value (and its elements) may be (from 0 to 100)
+                /// @param value set to the generated value (reusing its storage, and its elements')
+                void generate(Random &random, size_t size, value_type &value) const
+                {
+                    value.resize(static_cast<size_t>(random.below(std::min(maxLength, size) + 1)));
+                    for (size_t idx{0}; idx < value.size(); idx++)
+                    {
+                        if constexpr (std::is_same_v<typename Element::value_type, bool>)
+                        {
+                            bool generated{false};
+                            element.generate(random, size, generated);
+                            value[idx] = generated;
+                        }
+                        else
+                        {
+                            element.generate(random, size, value[idx]);
+                        }
+                    }
+                }
+
+                /// @brief gets simpler values to try in place of a failing one
+                /// @param value the failing value
+                /// @param candidates the simpler values are appended to this (the simplest first)
+                void shrink(const value_type &value, std::vector<value_type> &candidates) const
+                {
+                    if (value.empty())
+                    {
+                        return;
+                    }
+                    candidates.emplace_back();
+                    if (value.size() > 1)
+                    {
+                        candidates.emplace_back(value.begin(), value.begin() + value.size() / 2);
+                        candidates.emplace_back(value.begin() + value.size() / 2, value.end());
+                    }
+                    for (size_t idx{0}; idx < value.size() && idx < 32; idx++)
+                    {
+                        candidates.push_back(value);
+                        candidates.back().erase(candidates.back().begin() + idx);
+                    }
+
+                    // try the simpler replacements of each element
+                    std::vector<typename Element::value_type> elements;
+                    for (size_t idx{0}; idx < value.size() && idx < 32; idx++)
+                    {
+                        elements.clear();
+                        element.shrink(value[idx], elements);
+                        for (size_t choice{0}; choice < elements.size(); choice++)
+                        {
+                            candidates.push_back(value);
+                            candidates.back()[idx] = elements[choice];
+                        }
+                    }
+                }
+            };
+
+            /// @brief generates tuples of values from several other generators; shrinks one element at a time
+            /// @tparam Elements the generators of the elements
+            template <typename... Elements>
+            struct tuples
+            {
+                using value_type = std::tuple<typename Elements::value_type...>; ///< the type of the values generated
+
+                std::tuple<Elements...> elements; ///< the generators of the elements
+
+                /// @brief generates tuples
+                /// @param elementGenerators the generators of the elements
+                constexpr explicit tuples(Elements... elementGenerators) : elements{elementGenerators...} {}
+
+                /// @brief generates a value
+                /// @param random the source of random numbers
+                /// @param size how "big" the elements may be (from 0 to 100)
+                /// @param value set to the generated value (reusing the storage of its elements)
+                void generate(Random &random, size_t size, value_type &value) const
+                {
+                    generate_elements(random, size, value, std::index_sequence_for<Elements...>{});
+                }
+
+                /// @brief gets simpler values to try in place of a failing one
+                /// @param value the failing value
+                /// @param candidates the simpler values are appended to this (each with one element simplified)
+                void shrink(const value_type &value, std::vector<value_type> &candidates) const
+                {
+                    shrink_elements(value, candidates, std::index_sequence_for<Elements...>{});
+                }
+
+              private:
+                /// @brief generates each of the elements (in order)
+                template <size_t... Indices>
+                void generate_elements(Random &random, size_t size, value_type &value,
+                                       std::index_sequence<Indices...>) const
+                {
+                    (std::get<Indices>(elements).generate(random, size, std::get<Indices>(value)), ...);
+                }
+
+                /// @brief shrinks each of the elements (in order)
+                template <size_t... Indices>
+                void shrink_elements(const value_type &value, std::vector<value_type> &candidates,
+                                     std::index_sequence<Indices...>) const
+                {
+                    (shrink_element<Indices>(value, candidates), ...);
+                }
+
+                /// @brief shrinks one of the elements, keeping the others
+                template <size_t Index>
+                void shrink_element(const value_type &value, std::vector<value_type> &candidates) const
+                {
+                    std::vector<std::tuple_element_t<Index, value_type>> simpler;
+                    std::get<Index>(elements).shrink(std::get<Index>(value), simpler);
+                    for (size_t idx{0}; idx < simpler.size(); idx++)
+                    {
+                        candidates.push_back(value);
+                        std::get<Index>(candidates.back()) = std::move(simpler[idx]);
+                    }
+                }
+            };
+        } // namespace gen
+
+        namespace detail
+        {
+            /// @brief gets the number of inputs each property test checks ("--property-cases")
+            /// @return the number of inputs
+            size_t get_property_cases() noexcept;
+
+            /// @brief gets the seed of a property test's inputs (from its name, and "--property-seed")
+            /// @param name the name of the test
+            /// @return the seed
+            uint64_t get_property_seed(const char *name) noexcept;
+
+            /// @brief runs a function like a test, but without reporting (or logging) anything, to see if it passes
+            /// @param trial the function to run
+            /// @param context passed to the function
+            /// @return true if the function didn't fail an assertion (or expectation), or throw
+            bool run_property_trial(void (*trial)(const void *), const void *context);
+
+            /// @brief counts the failures recorded so far by the test running on the calling thread
+            /// @return the number of failed assertions (and expectations); 0 if no test is running on this thread
+            size_t get_failure_count() noexcept;
+
+            /// @brief writes the description of a property's counterexample to the log of the test running on the
+            /// calling thread, along with the "--property-seed" which reproduces it
+            /// @param message the description (without a newline)
+            void log_property_failure(const std::string &message);
+
+            /// @brief reports an input which failed a property while fuzzing, then aborts (so the fuzzer saves it)
+            /// @param description a description of the (generated) input
+            [[noreturn]] void fail_fuzz_input(const std::string &description);
+
+            /// @brief describes a floating point number (with enough digits to read it back exactly)
+            /// @param value the number
+            /// @return the description
+            std::string describe_real(double value);
+
+            /// @brief checks whether a type is a std::vector
+            template <typename T>
+            inline constexpr bool s_isVector{false};
+
+            /// @brief checks whether a type is a std::vector
+            template <typename T, typename Allocator>
+            inline constexpr bool s_isVector<std::vector<T, Allocator>>{true};
+
+            /// @brief checks whether a type is a std::tuple
+            template <typename T>
+            inline constexpr bool s_isTuple{false};
+
+            /// @brief checks whether a type is a std::tuple
+            template <typename... T>
+            inline constexpr bool s_isTuple<std::tuple<T...>>{true};
+
+            /// @brief describes a value generated for a property test (for the failure message)
+            /// @param value the value (a number, bool, string, or a vector or tuple of them)
+            /// @return the description
+            template <typename T>
+            std::string describe_value(const T &value)
+            {
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    return (value ? "true" : "false");
+                }
+                else if constexpr (std::is_integral_v<T>)
+                {
+                    return std::to_string(value);
+                }
+                else if constexpr (std::is_floating_point_v<T>)
+                {
+                    return describe_real(static_cast<double>(value));
+                }
+                else if constexpr (std::is_same_v<T, std::string>)
+                {
+                    constexpr const char *digits{"0123456789abcdef"};
+                    std::string           quoted{"\""};
+                    for (const char character : value)
+                    {
+                        const auto code{static_cast<unsigned char>(character)};
+                        if (character == '"' || character == '\\')
+                        {
+                            quoted.append(1, '\\').append(1, character);
+                        }
+                        else if (code < 0x20 || code >= 0x7F)
+                        {
+                            quoted.append("\\x").append(1, digits[code >> 4]).append(1, digits[code & 0xF]);
+                        }
+                        else
+                        {
+                            quoted.append(1, character);
+                        }
+                    }
+                    return quoted.append("\"");
+                }
+                else if constexpr (s_isVector<T>)
+                {
+                    std::string description{"{"};
+                    for (size_t idx{0}; idx < value.size(); idx++)
+                    {
+                        description.append(idx == 0 ? "" : ", ").append(describe_value(value[idx]));
+                    }
+                    return description.append("}");
+                }
+                else if constexpr (s_isTuple<T>)
+                {
+                    std::string description{"("};
+                    std::apply(
+                        [&description](const auto &...elements) {
+                            size_t idx{0};
+                            ((description.append(idx++ == 0 ? "" : ", ").append(describe_value(elements))), ...);
+                        },
+                        value);
+                    return description.append(")");
+                }
+                else
+                {
+                    return "(a value which can't be described)";
+                }
+            }
+
+            /// @brief combines the generators given to bTEST_PROPERTY
+            /// @param generators the generators
+            /// @return the generator, if there's only one; otherwise a generator of tuples
+            template <typename... Generators>
+            constexpr auto make_property_generator(Generators... generators)
+            {
+                if constexpr (sizeof...(Generators) == 1)
+                {
+                    return (generators, ...);
+                }
+                else
+                {
+                    return gen::tuples<Generators...>{generators...};
+                }
+            }
+
+            /// @brief runs the body of a property test with one input, for run_property_trial
+            /// @tparam Value the type of the input
+            template <typename Value>
+            struct PropertyTrial
+            {
+                void (*body)(const Value &){nullptr}; ///< the body of the property test
+                const Value *value{nullptr};          ///< the input to run it with
+
+                /// @brief checks whether the body passes with an input
+                /// @param input the input
+                /// @return true if the body passed
+                bool passes(const Value &input)
+                {
+                    value = &input;
+                    return run_property_trial(&run, this);
+                }
+
+                /// @brief runs the body (the trial function given to run_property_trial)
+                static void run(const void *context)
+                {
+                    const PropertyTrial &trial{*static_cast<const PropertyTrial *>(context)};
+                    trial.body(*trial.value);
+                }
+            };
+
+            /// @brief checks a property with (get_property_cases()) generated inputs; the first which fails is shrunk
+            /// to a minimal counterexample, which is described in the log and then run again (so it fails the test
+            /// the usual way)
+            /// @param file the name of the file containing the property test (must outlive the test)
+            /// @param line the line of the property test
+            /// @param name the name of the test
+            /// @param generator the generator of the inputs
+            /// @param body the body of the property test
+            template <typename Generator>
+            void check_property(const char *file, unsigned line, const char *name, const Generator &generator,
+                                void (*body)(const typename Generator::value_type &))
+            {
+                using Value = typename Generator::value_type;
+
+                const size_t         cases{get_property_cases()};
+                const uint64_t       seed{get_property_seed(name)};
+                PropertyTrial<Value> trial{body};
+                Value                value{};
+                for (size_t idx{0}; idx < cases; idx++)
+                {
+                    Random random{seed ^ (idx * 0x9E3779B97F4A7C15ull)};
+                    generator.generate(random, cases > 1 ? idx * 100 / (cases - 1) : 100, value);
+                    if (trial.passes(value))
+                    {
+                        continue;
+                    }
+
+                    // greedily take the first simpler input which still fails, until none do
+                    size_t             steps{0};
+                    std::vector<Value> candidates;
+                    for (bool shrunk{true}; shrunk && steps < bTESTS_PROPERTY_SHRINKS;)
+                    {
+                        shrunk = false;
+                        candidates.clear();
+                        generator.shrink(value, candidates);
+                        for (size_t choice{0}; choice < candidates.size() && steps < bTESTS_PROPERTY_SHRINKS; choice++)
+                        {
+                            steps++;
+                            if (!trial.passes(candidates[choice]))
+                            {
+                                value  = std::move(candidates[choice]);
+                                shrunk = true;
+                                break;
+                            }
+                        }
+                    }
+
+                    log_property_failure("property failed on input " + std::to_string(idx + 1) + " of " +
+                                         std::to_string(cases) + ", shrunk in " + std::to_string(steps) +
+                                         " steps to: " + describe_value(value));
+                    // a counterexample fails the test even if (being flaky) it passes when it's run again
+                    const size_t failures{get_failure_count()};
+                    body(value);
+                    if (get_failure_count() == failures)
+                    {
+                        record_failure(file, line, "the counterexample passed when it was run again");
+                    }
+                    return;
+                }
+            }
+
+            /// @brief checks a property with an input generated from a fuzzer's input (see bTEST_PROPERTY_FUZZER)
+            /// @param generator the generator of the inputs
+            /// @param body the body of the property test
+            /// @param data the bytes of the fuzzer's input
+            /// @param size the number of bytes
+            /// @return 0 (the input is reported, and the process aborted, if it fails the property)
+            template <typename Generator>
+            int fuzz_property(const Generator &generator, void (*body)(const typename Generator::value_type &),
+                              const unsigned char *data, size_t size)
+            {
+                using Value = typename Generator::value_type;
+
+                Random random{data, size};
+                Value  value{};
+                generator.generate(random, 100, value);
+                if (!PropertyTrial<Value>{body}.passes(value))
+                {
+                    fail_fuzz_input(describe_value(value));
+                }
+                return 0;
+            }
+        } // namespace detail
+    } // namespace tests
+} // namespace ben
+
+//--Implementation------------------------------------------------------------------------------------------------------
+
+// only add the implementations to one single file where bTEST_IMPLEMENTATION is defined
+#ifdef bTEST_IMPLEMENTATION
+#    include <algorithm>          // for std::min, std::sort (benchmark samples)
+#    include <array>              // for the ring of log buffers
+#    include <atomic>             // for thread-safe accounting of the test results
+#    include <bit>                // for storing the metrics in the trend file (as the bits of floats)
+#    include <charconv>           // for parsing numeric command line arguments
+#    include <cmath>              // for the standard deviation of benchmark samples
+#    include <cstdint>            // for hashing tests into shards
+#    include <cstdio>             // for formatting benchmark statistics
+#    include <cstdlib>            // for reading the sharding environment variables
+#    include <condition_variable> // for waiting on results from the worker threads
+#    include <csignal>            // for flushing the log if the application crashes
+#    include <ctime>              // for the dates of the runs in the trend file
+#    include <deque>              // for the per-worker queues of tests
+#    include <fstream>            // for reading/writing the history file
+#    include <functional>         // for the callbacks of the async tests, and ordering their timers
+#    include <iostream>           // for printing to console, etc
+#    include <latch>              // for starting the threads of a stressed test together
+#    include <map>                // for the (sorted) history of the tests
+#    include <memory>             // for the log buffers
+#    include <mutex>              // for guarding the per-worker queues and the results
+#    include <new>                // for replacing operator new/delete (to track allocations)
+#    include <queue>              // for the timers of the async tests
+#    include <random>             // for shuffling the tests (reproducibly, from a seed)
+#    include <set>                // for the groups with a failure (when running them first)
+#    include <string_view>        // for viewing test/group names and command line arguments
+#    include <thread>             // for the worker threads
+#    include <tuple>              // for comparing fixture keys
+#    include <vector>             // for the flattened list of tests and their results
+#    ifdef _WIN32
+#        ifndef WIN32_LEAN_AND_MEAN
+#            define WIN32_LEAN_AND_MEAN
+#        endif // !WIN32_LEAN_AND_MEAN
+#        ifndef NOMINMAX
+#            define NOMINMAX
+#        endif                // !NOMINMAX
+#        include <io.h>      // for _isatty (only drawing the progress line on a console)
+#        include <windows.h> // for GetThreadTimes
+#    else
+#        include <time.h> // for clock_gettime (per-thread CPU time)
+#    endif                // _WIN32
+#    if defined(__x86_64__) || defined(__i386__)
+#        include <x86intrin.h> // for __rdtsc (counting time stamp counter ticks, without hardware counters)
+#    elif defined(_M_X64) || defined(_M_IX86)
+#        include <intrin.h> // for __rdtsc
+#    endif                  // __x86_64__ || __i386__
+#    ifdef __linux__
+#        include <linux/perf_event.h> // for counting hardware events (cycles, instructions, misses)
+#        include <sys/syscall.h>      // for perf_event_open (which has no libc wrapper)
+#    endif                            // __linux__
+#    ifndef _WIN32
+#        include <cerrno>     // for checking why reads/writes to worker processes were interrupted
+#        include <chrono>     // for timing out tests which run in worker processes
+#        include <signal.h>   // for killing (and identifying the signals which killed) worker processes
+#        include <cstdint>    // for the fixed width integers sent to/from worker processes
+#        include <cstring>    // for strsignal
+#        include <poll.h>     // for waiting on results from the worker processes
+#        include <sys/wait.h> // for reaping worker processes
+#        include <unistd.h>   // for fork, pipes, isatty, etc
+#    endif                    // !_WIN32
+#    ifndef bTESTS_NO_LOG
+#        ifndef bTESTS_LOG_FILE
+/// @brief the default log file name; if bTESTS_LOG_FILE is defined by the user (before this point) then that value is
+/// used instead
+#            define bTESTS_LOG_FILE "tests.txt"
+#        endif // !bTESTS_LOG_FILE
+#        ifndef bTESTS_LOG_BUFFER_SIZE
+/// @brief the size (in bytes) of each of the buffers the log file is written through
+#            define bTESTS_LOG_BUFFER_SIZE (256 * 1024)
+#        endif // !bTESTS_LOG_BUFFER_SIZE
+#    endif     // !bTEST_NO_LOG
+#    ifndef bTESTS_NO_HISTORY
+#        ifndef bTESTS_HISTORY_FILE
+/// @brief the default history file name (the timings and outcomes of the last run of each test); if
+/// bTESTS_HISTORY_FILE is defined by the user (before this point) then that value is used instead
+#            define bTESTS_HISTORY_FILE "tests.history"
+#        endif // !bTESTS_HISTORY_FILE
+#    else
+#        undef bTESTS_HISTORY_FILE
+#        define bTESTS_HISTORY_FILE ""
+#    endif // !bTESTS_NO_HISTORY
+#    ifndef bTESTS_SLOWEST
+/// @brief the (default) number of slowest tests to list in the summary
+#        define bTESTS_SLOWEST 5
+#    endif // !bTESTS_SLOWEST
+#    ifndef bTESTS_WATCHDOG_INTERVAL_MS
+/// @brief how often (in milliseconds) the watchdog checks the timeouts of the running tests
+#        define bTESTS_WATCHDOG_INTERVAL_MS 20
+#    endif // !bTESTS_WATCHDOG_INTERVAL_MS
+#    ifndef bTESTS_BENCHMARK_WARMUP_MS
+/// @brief how long (in milliseconds) each benchmark is run before any measurements are taken
+#        define bTESTS_BENCHMARK_WARMUP_MS 100
+#    endif // !bTESTS_BENCHMARK_WARMUP_MS
+#    ifndef bTESTS_BENCHMARK_SAMPLE_MS
+/// @brief roughly how long (in milliseconds) each measured sample of a benchmark should take; the number of
+/// iterations per sample is calibrated to match
+#        define bTESTS_BENCHMARK_SAMPLE_MS 10
+#    endif // !bTESTS_BENCHMARK_SAMPLE_MS
+#    ifndef bTESTS_BENCHMARK_SAMPLES
+/// @brief how many measured samples are taken of each benchmark
+#        define bTESTS_BENCHMARK_SAMPLES 30
+#    endif // !bTESTS_BENCHMARK_SAMPLES
+#    ifndef bTESTS_REGRESSION_THRESHOLD
+/// @brief the (default) change in the median time of a benchmark, in percent, which counts as a regression (or an
+/// improvement) when comparing with a baseline-- if the change is also statistically significant
+#        define bTESTS_REGRESSION_THRESHOLD 5.0
+#    endif // !bTESTS_REGRESSION_THRESHOLD
+#    ifndef bTESTS_BASELINE_SIGNIFICANCE
+/// @brief the significance level of the Mann-Whitney U test used to compare benchmarks with a baseline (a change is
+/// only reported if the p-value is below this)
+#        define bTESTS_BASELINE_SIGNIFICANCE 0.01
+#    endif // !bTESTS_BASELINE_SIGNIFICANCE
+#    ifndef bTESTS_TREND_FILE
+/// @brief the (default) trend file each run appends its measurements to (see "--trend-file"); empty for none
+#        define bTESTS_TREND_FILE ""
+#    endif // !bTESTS_TREND_FILE
+#    ifndef bTESTS_TREND_TAG
+/// @brief the (default) tag of the runs appended to the trend file, e.g. a commit hash (see "--trend-tag")
+#        define bTESTS_TREND_TAG bTESTS_BUILD_ID
+#    endif // !bTESTS_TREND_TAG
+#    ifndef bTESTS_TREND_MIN_RUNS
+/// @brief the fewest runs "--trend" compares on either side of a step change
+#        define bTESTS_TREND_MIN_RUNS 4
+#    endif // !bTESTS_TREND_MIN_RUNS
+#    ifndef bTESTS_TREND_SIGNIFICANCE
+/// @brief the significance level of the Mann-Whitney U test "--trend" uses to tell a step change from the noise;
+/// looser than bTESTS_BASELINE_SIGNIFICANCE, since there are only ever a few runs on either side
+#        define bTESTS_TREND_SIGNIFICANCE 0.05
+#    endif // !bTESTS_TREND_SIGNIFICANCE
+#    ifndef bTESTS_PROPERTY_CASES
+/// @brief the (default) number of generated inputs each property test checks
+#        define bTESTS_PROPERTY_CASES 1000
+#    endif // !bTESTS_PROPERTY_CASES
+#    ifndef bTESTS_RESOURCE_LIMITS
+/// @brief the (default) number of tests which may use each resource at once (see "--resource-limits"), as comma
+/// separated "name=N" pairs; resources which aren't listed are used by one test at a time
+#        define bTESTS_RESOURCE_LIMITS ""
+#    endif // !bTESTS_RESOURCE_LIMITS
+#    ifndef bTESTS_ASYNC_THREADS
+/// @brief the number of threads of the event loop which drives the async (coroutine) tests
+#        define bTESTS_ASYNC_THREADS 2
+#    endif // !bTESTS_ASYNC_THREADS
+#    ifndef bTESTS_PROGRESS_INTERVAL_MS
+/// @brief how often (in milliseconds, at most) the progress line is redrawn with "--quiet"
+#        define bTESTS_PROGRESS_INTERVAL_MS 100
+#    endif // !bTESTS_PROGRESS_INTERVAL_MS
+#    ifdef bTESTS_SELF_BENCHMARK
+#        ifndef bTESTS_SELF_BENCHMARK_TESTS
+/// @brief the number of empty tests registered when bTESTS_SELF_BENCHMARK is defined
+#            define bTESTS_SELF_BENCHMARK_TESTS 100000
+#        endif // !bTESTS_SELF_BENCHMARK_TESTS
+#    endif     // bTESTS_SELF_BENCHMARK
+
+#    ifdef bTESTS_USE_LINKER_SECTION
+// the linker defines these to mark the bounds of the section of registrations (they're weak, so they're null if no
+// test was registered through the section)
+extern "C" const ben::tests::detail::Registration *const __start_bTESTS_registrations[] __attribute__((weak));
+extern "C" const ben::tests::detail::Registration *const __stop_bTESTS_registrations[] __attribute__((weak));
+#    endif // bTESTS_USE_LINKER_SECTION
+
+namespace
+{
+    //--Implementation Types--------------------------------------------------------------------------------------------
+
+    /// @brief possible return values for the program-- either all the tests passed or at least one test failed!
+    enum struct ReturnValue : int
+    {
+        pass = 0,  ///< all tests passed!
+        fail = -1, ///< at least one test failed
+    };
+
+    /// @brief the options which control how the tests are run (set from the command line arguments)
+    struct Options
+    {
+#    ifdef bTESTS_PARALLEL
+        size_t jobs{0}; ///< the number of worker threads to run the tests on (0 means one per hardware thread)
+#    else
+        size_t jobs{1}; ///< the number of worker threads to run the tests on (0 means one per hardware thread)
+#    endif // bTESTS_PARALLEL
+        bool jobsGiven{false}; ///< whether or not the number of jobs was given on the command line
+#    ifdef bTESTS_ISOLATE
+        bool isolate{true}; ///< whether or not to run each test in a (reused) worker process
+#    else
+        bool isolate{false}; ///< whether or not to run each test in a (reused) worker process
+#    endif // bTESTS_ISOLATE
+        double timeout{0.0}; ///< the number of seconds a test may run for before failing (0 means no limit)
+        double globalTimeout{0.0}; ///< the number of seconds the whole run may take (0 means no limit)
+        bool   benchmarks{true}; ///< whether or not to run the benchmarks (after the tests)
+        std::string baselineFile;     ///< the baseline to compare the benchmarks with (empty for none)
+        std::string saveBaselineFile; ///< where to save the benchmark samples as a baseline (empty for nowhere)
+        std::string trendFile{bTESTS_TREND_FILE}; ///< the trend file each run is appended to (empty for none)
+        std::string trendTag{bTESTS_TREND_TAG};   ///< what the runs appended to the trend file are tagged with
+        std::string trendPattern; ///< the tests "--trend" prints the trends of (empty to run the tests instead)
+        double regressionThreshold{bTESTS_REGRESSION_THRESHOLD}; ///< the change (in percent) which is a regression
+        size_t slowest{bTESTS_SLOWEST}; ///< how many of the slowest tests to list in the summary
+        std::string junitFile; ///< where to write the results as JUnit XML (empty for nowhere)
+        std::string jsonFile;  ///< where to write the results as JSON lines (empty for nowhere)
+        size_t shardIndex{0};           ///< which shard (counting from 0) of the tests to run
+        size_t totalShards{1};          ///< how many shards the tests are split into (1 means run every test)
+        std::vector<std::string> nameFilters;  ///< glob patterns for the names of the tests to run ("-" to exclude)
+        std::vector<std::string> groupFilters; ///< glob patterns for the groups of the tests to run ("-" to exclude)
+        bool                     list{false};  ///< whether to list the (selected) tests instead of running them
+        std::string historyFile{bTESTS_HISTORY_FILE}; ///< where the history is read from/written to (empty for none)
+        std::string shardTimingsFile; ///< the history used to balance the shards (empty to shard by hash instead)
+        size_t      failFast{0};      ///< how many tests may fail before no more are started (0 means no limit)
+        size_t      repeat{1};        ///< how many times to run each test
+        bool        repeatGiven{false}; ///< whether or not the number of repetitions was given on the command line
+        bool        repeatUntilFail{false}; ///< whether to stop repeating a test once it fails
+        size_t      stress{1};        ///< how many threads run each repetition of a test at once
+        bool        failedFirst{false}; ///< whether to run the tests which failed last time (and their groups) first
+#    ifdef bTESTS_SHUFFLE
+        bool shuffle{true}; ///< whether to shuffle the groups, and the tests within each group
+#    else
+        bool shuffle{false}; ///< whether to shuffle the groups, and the tests within each group
+#    endif // bTESTS_SHUFFLE
+        size_t seed{0};          ///< the seed the tests are shuffled with
+        bool   seedGiven{false}; ///< whether or not the seed was given on the command line
+        size_t propertyCases{bTESTS_PROPERTY_CASES}; ///< how many generated inputs each property test checks
+        size_t propertySeed{0}; ///< mixed into the seed of each property test (0 repeats the inputs of every run)
+        std::string resourceLimits{bTESTS_RESOURCE_LIMITS}; ///< how many tests may use each resource at once
+#    ifdef bTESTS_CACHE
+        bool cache{true}; ///< whether to skip the tests which passed last time (and haven't been rebuilt since)
+#    else
+        bool cache{false}; ///< whether to skip the tests which passed last time (and haven't been rebuilt since)
+#    endif // bTESTS_CACHE
+#    ifdef bTESTS_COUNTERS
+        bool counters{true}; ///< whether to count hardware events (cycles, instructions, misses) for each test
+#    else
+        bool counters{false}; ///< whether to count hardware events (cycles, instructions, misses) for each test
+#    endif // bTESTS_COUNTERS
+#    ifdef bTESTS_QUIET
+        bool quiet{true}; ///< whether to only print the failing tests (and a progress line) to the console
+#    else
+        bool quiet{false}; ///< whether to only print the failing tests (and a progress line) to the console
+#    endif // bTESTS_QUIET
+#    ifdef bTESTS_PROFILE_RUNNER
+        bool profileRunner{true}; ///< whether to time the runner's own work (by phase) against the test bodies
+#    else
+        bool profileRunner{false}; ///< whether to time the runner's own work (by phase) against the test bodies
+#    endif // bTESTS_PROFILE_RUNNER
+    };
+
+    /// @brief the phases of a run which "--profile-runner" times (the time spent in each is summed over every thread)
+    enum struct RunnerPhase : size_t
+    {
+        registration = 0, ///< turning the registrations into test cases (and parsing their attributes)
+        scheduling   = 1, ///< selecting, ordering, and handing out the tests (plus the watchdog's bookkeeping)
+        capture      = 2, ///< routing the output, counting allocations, and timing around each test body
+        log          = 3, ///< writing to the log file, and reading/writing the history
+        reporting    = 4, ///< formatting the results for the console and the reporters, and tearing down fixtures
+        tests        = 5, ///< the test (and benchmark) bodies themselves
+        count        = 6, ///< the number of phases
+    };
+
+    /// @brief a single test (or benchmark), copied out of the list of registrations so that the tests can be indexed
+    struct TestCase
+    {
+        std::string_view             group;              ///< the name of the group the test belongs to
+        std::string_view             name;               ///< the name of the test
+        ben::tests::bTestFnType      func{nullptr};      ///< the function which implements the test
+        ben::tests::bBenchmarkFnType benchmark{nullptr}; ///< the function which implements the benchmark
+        std::string_view             attributes;         ///< the attributes of the test (as given to the macro)
+        double                       timeout{0.0};       ///< the test's own timeout in seconds (0 to use the default)
+        uint64_t                     fingerprint{0};     ///< identifies the build of the test (0 if unknown)
+        ben::tests::bAsyncFnType     asyncTest{nullptr}; ///< the coroutine which implements an async test
+        bool                         exclusive{false};   ///< whether the test has to run alone (see ResourceGate)
+        size_t                       threads{0};         ///< how many threads the test takes (0 if it doesn't say)
+    };
+
+    /// @brief the possible outcomes of running a single test
+    enum struct TestStatus : int
+    {
+        passed    = 0, ///< the test returned normally
+        failed    = 1, ///< the test threw an exception (i.e. an assertion failed)
+        crashed   = 2, ///< the process running the test died (only possible when running tests in worker processes)
+        timed_out = 3, ///< the test ran for longer than the timeout allows
+    };
+
+    /// @brief the hardware events counted while a test (or a benchmark loop) ran (see "--counters")
+    struct CounterValues
+    {
+        static constexpr unsigned cyclesEvent{1u << 0};       ///< set in events if the cycles were counted
+        static constexpr unsigned instructionsEvent{1u << 1}; ///< set in events if the instructions were counted
+        static constexpr unsigned cacheMissesEvent{1u << 2};  ///< set in events if the cache misses were counted
+        static constexpr unsigned branchMissesEvent{1u << 3}; ///< set in events if the branch misses were counted
+        static constexpr unsigned tscEvent{1u << 4}; ///< set in events if the cycles are time stamp counter ticks
+
+        unsigned events{0};         ///< which of the values were counted
+        double   cycles{0.0};       ///< CPU cycles (or time stamp counter ticks, if that's all there is)
+        double   instructions{0.0}; ///< instructions retired
+        double   cacheMisses{0.0};  ///< (last level) cache misses
+        double   branchMisses{0.0}; ///< mispredicted branches
+    };
+
+    /// @brief the result of running a single test
+    struct TestResult
+    {
+        TestStatus  status{TestStatus::failed}; ///< the outcome of the test
+        std::string failure;    ///< where (or how) the test failed (only meaningful if the test did not pass)
+        std::string expression; ///< the text of the assertion which failed (if the test failed an assertion)
+        std::string log;        ///< the (captured) output of the test
+        size_t      failures{0};  ///< how many checks failed (expectations, plus an assertion or exception)
+        double      wallNs{0.0}; ///< how long the test took (in nanoseconds of wall-clock time)
+        double      cpuNs{0.0};  ///< how much CPU time the test used (in nanoseconds, on the thread which ran it)
+        size_t      allocations{0};    ///< how many allocations the test made (if bTESTS_TRACK_ALLOCATIONS)
+        size_t      allocatedBytes{0}; ///< how many bytes the test allocated (in total)
+        size_t      peakBytes{0};      ///< the most bytes the test had allocated at once
+        size_t      leakedBytes{0};    ///< how many bytes the test allocated but never freed
+        CounterValues counters;        ///< the hardware events counted while the test ran (if "--counters")
+        size_t      runs{1};           ///< how many times the test ran (see "--repeat" and "--stress")
+        size_t      failedRuns{0};     ///< how many of those runs failed (only counted if the test ran more than once)
+        double      minRunNs{0.0};     ///< the wall time of the fastest run (if the test ran more than once)
+        double      meanRunNs{0.0};    ///< the mean wall time of the runs
+        double      maxRunNs{0.0};     ///< the wall time of the slowest run
+    };
+
+    /// @brief the time taken by a test (kept for every test so the slowest ones can be listed in the summary)
+    struct TestTiming
+    {
+        double     wallNs{0.0};                 ///< how long the test took (in nanoseconds of wall-clock time)
+        double     cpuNs{0.0};                  ///< how much CPU time the test used (in nanoseconds)
+        TestStatus status{TestStatus::passed}; ///< the outcome of the test
+        bool       ran{false};                  ///< whether the test ran at all (see "--fail-fast")
+    };
+
+    /// @brief what the history file recorded about the last run of a test
+    struct HistoryEntry
+    {
+        TestStatus status{TestStatus::passed}; ///< the outcome of the test
+        size_t     wallNs{0};                   ///< how long the test took (in nanoseconds of wall-clock time)
+        uint64_t   fingerprint{0};              ///< the fingerprint of the test when it ran (0 if unknown)
+    };
+
+    /// @brief the history of the tests, keyed by group and name (see get_history_key())
+    using History = std::map<std::string, HistoryEntry>;
+
+    /// @brief the metrics the trend file records about each test (and each benchmark) in each run
+    enum struct TrendMetric : size_t
+    {
+        time         = 0, ///< the (mean) wall time of a test, or the median time per iteration of a benchmark
+        cpu          = 1, ///< the CPU time used (in nanoseconds)
+        allocations  = 2, ///< the number of allocations made (see bTESTS_TRACK_ALLOCATIONS)
+        bytes        = 3, ///< the number of bytes allocated
+        cycles       = 4, ///< CPU cycles or time stamp counter ticks (per iteration for a benchmark; see "--counters")
+        instructions = 5, ///< instructions retired (likewise)
+        cacheMisses  = 6, ///< cache misses (likewise)
+        branchMisses = 7, ///< mispredicted branches (likewise)
+        count        = 8, ///< the number of metrics
+    };
+
+    /// @brief what the trend file records about a test (or a benchmark) in one run
+    struct TrendRecord
+    {
+        static constexpr uint8_t benchmarkFlag{0x80}; ///< set in flags if the record is of a benchmark
+        static constexpr uint8_t tscFlag{0x40};       ///< set in flags if the cycles are time stamp counter ticks
+        static constexpr uint8_t statusMask{0x0f};    ///< the bits of flags holding the status of the test
+
+        uint64_t id{0};    ///< identifies the test (see hash_test_case())
+        uint8_t  flags{0}; ///< the status of the test, plus benchmarkFlag and tscFlag
+        std::array<float, static_cast<size_t>(TrendMetric::count)> metrics{}; ///< the metrics (see TrendMetric)
+    };
+
+    /// @brief a run of a test, as read back from the trend file
+    struct TrendPoint
+    {
+        int64_t     time{0}; ///< when the run was appended (in seconds since the Unix epoch)
+        std::string tag;     ///< what the run was tagged with (see "--trend-tag")
+        TrendRecord record;  ///< what the run recorded about the test
+    };
+
+    /// @brief the result of running a single benchmark
+    struct BenchmarkResult
+    {
+        TestResult          result;        ///< whether the benchmark ran successfully (and its captured output)
+        size_t              iterations{0}; ///< the (calibrated) number of iterations in each sample
+        std::vector<double> samples;       ///< the measured time per iteration (in nanoseconds) of each sample
+        CounterValues       counters;      ///< the hardware events counted in the loops of all of the samples
+    };
+
+    /// @brief the (measured) samples of each benchmark in a baseline, keyed by group and name (see get_history_key())
+    using Baseline = std::map<std::string, std::vector<double>>;
+
+    /// @brief how a benchmark compares with its baseline
+    enum struct BaselineVerdict : int
+    {
+        none      = 0, ///< the benchmark wasn't compared (no baseline, or no samples)
+        unchanged = 1, ///< any change is within the noise (not significant, or below the threshold)
+        improved  = 2, ///< the benchmark got significantly faster
+        regressed = 3, ///< the benchmark got significantly slower
+    };
+
+    /// @brief the comparison of a benchmark with its baseline
+    struct BaselineComparison
+    {
+        BaselineVerdict verdict{BaselineVerdict::none}; ///< the outcome of the comparison
+        double          change{0.0}; ///< the change in the median time per iteration (in percent, positive is slower)
+        double          p{1.0};      ///< the (two-sided) p-value of the Mann-Whitney U test
+    };
+
+    /// @brief formats the change measured by a comparison with the baseline
+    /// @param comparison the comparison
+    /// @return the formatted change (e.g. "median +12.34%, p = 0.0001")
+    std::string format_comparison(const BaselineComparison &comparison)
+    {
+        char buffer[64]{};
+        std::snprintf(buffer, sizeof(buffer), "median %+.2f%%, p = %.2g", comparison.change, comparison.p);
+        return buffer;
+    }
+
+    /// @brief the statistics of the samples of a benchmark (all in nanoseconds per iteration)
+    struct BenchmarkStats
+    {
+        double min{0.0};    ///< the fastest sample
+        double median{0.0}; ///< the median sample
+        double mean{0.0};   ///< the mean of the samples
+        double stddev{0.0}; ///< the (sample) standard deviation of the samples
+    };
+
+    /// @brief the allocations made by a thread (see bTESTS_TRACK_ALLOCATIONS)
+    struct AllocationCounters
+    {
+        size_t    allocations{0}; ///< how many allocations have been made
+        size_t    bytes{0};       ///< how many bytes have been allocated (in total)
+        long long liveBytes{0};   ///< how many bytes are allocated right now (negative if other threads freed more)
+        long long peakBytes{0};   ///< the most bytes which have been allocated at once (since it was last reset)
+        unsigned  paused{0};      ///< allocations aren't counted while this is non-zero (see AllocationPause)
+    };
+
+    /// @brief gets the allocations made by the calling thread
+    /// @return a reference to the (thread local) counters
+    AllocationCounters &thread_allocations() noexcept
+    {
+        thread_local AllocationCounters t_allocations{};
+        return t_allocations;
+    }
+
+    /// @brief stops counting the allocations made by the calling thread while it exists, so the framework's own
+    /// bookkeeping (captured output, failure messages, fixtures) isn't blamed on the test
+    struct AllocationPause
+    {
+        AllocationPause() noexcept { thread_allocations().paused++; }
+        ~AllocationPause() { thread_allocations().paused--; }
+        AllocationPause(const AllocationPause &)            = delete;
+        AllocationPause &operator=(const AllocationPause &) = delete;
+    };
+
+#    ifdef bTESTS_TRACK_ALLOCATIONS
+    /// @brief stored just in front of every allocation made through operator new, so it can be uncounted when freed
+    struct AllocationHeader
+    {
+        size_t size{0};        ///< the size which was asked for
+        size_t offset{0};      ///< how far the allocation is from the start of the block which was malloc'd
+        bool   counted{false}; ///< whether the allocation was counted (it isn't if counting was paused)
+    };
+
+    /// @brief allocates memory for operator new, counting it for the calling thread
+    /// @param size the number of bytes to allocate
+    /// @param alignment the alignment of the allocation (a power of two)
+    /// @return the allocation, or nullptr if there isn't enough memory
+    void *allocate_tracked(size_t size, size_t alignment) noexcept
+    {
+        alignment = std::max(alignment, alignof(AllocationHeader));
+        const size_t overhead{sizeof(AllocationHeader) + alignment - 1};
+        if (size > static_cast<size_t>(-1) - overhead)
+        {
+            return nullptr;
+        }
+
+        void *const block{std::malloc(size + overhead)};
+        if (block == nullptr)
+        {
+            return nullptr;
+        }
+
+        // the allocation is aligned within the block, leaving (at least) enough room for the header in front of it
+        const std::uintptr_t start{reinterpret_cast<std::uintptr_t>(block)};
+        const std::uintptr_t memory{(start + overhead) & ~static_cast<std::uintptr_t>(alignment - 1)};
+
+        AllocationCounters &counters{thread_allocations()};
+        const bool          counted{counters.paused == 0};
+        ::new (reinterpret_cast<AllocationHeader *>(memory) - 1) AllocationHeader{size, memory - start, counted};
+        if (counted)
+        {
+            counters.allocations++;
+            counters.bytes += size;
+            counters.liveBytes += static_cast<long long>(size);
+            counters.peakBytes = std::max(counters.peakBytes, counters.liveBytes);
+        }
+        return reinterpret_cast<void *>(memory);
+    }
+
+    /// @brief frees memory allocated by allocate_tracked, uncounting it for the calling thread
+    /// @param memory the allocation to free (may be nullptr)
+    void deallocate_tracked(void *memory) noexcept
+    {
+        if (memory == nullptr)
+        {
+            return;
+        }
+
+        const AllocationHeader *const header{static_cast<const AllocationHeader *>(memory) - 1};
+        if (header->counted)
+        {
+            thread_allocations().liveBytes -= static_cast<long long>(header->size);
+        }
+        std::free(static_cast<char *>(memory) - header->offset);
+    }
+
+    /// @brief allocates memory for (the throwing forms of) operator new, calling the new handler until it succeeds
+    /// @param size the number of bytes to allocate
+    /// @param alignment the alignment of the allocation (a power of two)
+    /// @return the allocation
+    /// @note throws std::bad_alloc (or aborts, if exceptions are disabled) if there's no new handler to free up memory
+    void *allocate_or_throw(size_t size, size_t alignment)
+    {
+        while (true)
+        {
+            void *const memory{allocate_tracked(size, alignment)};
+            if (memory != nullptr)
+            {
+                return memory;
+            }
+
+            const std::new_handler handler{std::get_new_handler()};
+            if (handler == nullptr)
+            {
+#        ifndef bTESTS_NO_EXCEPTIONS
+                throw std::bad_alloc{};
+#        else
+                std::abort();
+#        endif // !bTESTS_NO_EXCEPTIONS
+            }
+            handler();
+        }
+    }
+
+    /// @brief allocates memory for (the nothrow forms of) operator new
+    /// @param size the number of bytes to allocate
+    /// @param alignment the alignment of the allocation (a power of two)
+    /// @return the allocation, or nullptr if there isn't enough memory
+    void *allocate_or_null(size_t size, size_t alignment) noexcept
+    {
+#        ifndef bTESTS_NO_EXCEPTIONS
+        try
+        {
+            return allocate_or_throw(size, alignment);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+#        else
+        return allocate_tracked(size, alignment);
+#        endif // !bTESTS_NO_EXCEPTIONS
+    }
+#    endif // bTESTS_TRACK_ALLOCATIONS
+
+    /// @brief a stream buffer which appends everything written to it to a string (used to capture a test's output)
+    class CaptureBuffer : public std::streambuf
+    {
+      public:
+        /// @brief creates a buffer which appends to the given string
+        /// @param output the string to append the captured output to
+        explicit CaptureBuffer(std::string &output) : m_output{output} {};
+
+      protected:
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                const AllocationPause pause;
+                m_output.push_back(traits_type::to_char_type(ch));
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char *s, std::streamsize count) override
+        {
+            const AllocationPause pause;
+            m_output.append(s, static_cast<size_t>(count));
+            return count;
+        }
+
+      private:
+        std::string &m_output;
+    };
+
+    /// @brief a stream buffer which forwards everything written to it to a buffer chosen by the calling thread
+    ///
+    /// std::cout's buffer is process-global state, so it can't be swapped out per test when the tests run on more than
+    /// one thread. Instead, std::cout is pointed at one of these for the duration of the run, and each thread sets its
+    /// own target (or no target at all, which discards the output). The thread which reports the results targets the
+    /// original std::cout buffer
+    class ThreadRoutingBuffer : public std::streambuf
+    {
+      public:
+        /// @brief gets the target buffer for the calling thread
+        /// @return a reference to the (thread local) target buffer pointer
+        static std::streambuf *&target()
+        {
+            thread_local std::streambuf *t_target{nullptr};
+            return t_target;
+        }
+
+      protected:
+        int_type overflow(int_type ch) override
+        {
+            std::streambuf *const buffer{target()};
+            if (buffer == nullptr || traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                return traits_type::not_eof(ch);
+            }
+            return buffer->sputc(traits_type::to_char_type(ch));
+        }
+
+        std::streamsize xsputn(const char *s, std::streamsize count) override
+        {
+            std::streambuf *const buffer{target()};
+            return (buffer == nullptr ? count : buffer->sputn(s, count));
+        }
+
+        int sync() override
+        {
+            std::streambuf *const buffer{target()};
+            return (buffer == nullptr ? 0 : buffer->pubsync());
+        }
+    };
+
+    /// @brief routes std::cout through a ThreadRoutingBuffer for as long as it is alive
+    ///
+    /// the creating thread's target is the original std::cout buffer (so it keeps printing to the console), while
+    /// every other thread's output is discarded unless it sets a target of its own
+    class CoutRouting
+    {
+      public:
+        CoutRouting() : m_coutBuffer{std::cout.rdbuf()}
+        {
+            std::cout.rdbuf(&m_routingBuffer);
+            ThreadRoutingBuffer::target() = m_coutBuffer;
+        }
+
+        ~CoutRouting()
+        {
+            // switch std::cout's rdbuf back to the old value!
+            ThreadRoutingBuffer::target() = nullptr;
+            std::cout.rdbuf(m_coutBuffer);
+        }
+
+        CoutRouting(const CoutRouting &)            = delete;
+        CoutRouting &operator=(const CoutRouting &) = delete;
+
+      private:
+        std::streambuf *const m_coutBuffer;
+        ThreadRoutingBuffer   m_routingBuffer;
+    };
+
+#    ifndef bTESTS_NO_LOG
+    /// @brief the log file; writes are batched into large buffers which a background thread writes out, so the thread
+    /// reporting the results never waits on the file system (unless the writer falls a whole ring of buffers behind)
+    ///
+    /// the buffers form a single producer/single consumer ring: the reporting thread fills the buffer at the head and
+    /// publishes it (by bumping m_head) when it's full, and the writer thread writes out the buffers between the tail
+    /// and the head (bumping m_tail as each one is done). Neither side takes a lock
+    class AsyncLog
+    {
+      public:
+        AsyncLog() = default;
+
+        AsyncLog(const AsyncLog &)            = delete;
+        AsyncLog &operator=(const AsyncLog &) = delete;
+
+        /// @brief writes out everything which is still buffered
+        ~AsyncLog()
+        {
+            close();
+        }
+
+        /// @brief opens the file and starts the writer thread
+        /// @param path the name of the file
+        void open(const char *path)
+        {
+            m_file = std::fopen(path, "wb");
+            if (m_file == nullptr)
+            {
+                return;
+            }
+            // the buffers are already large; leaving nothing in stdio's buffer also means a forked child which calls
+            // exit can't write any of it out a second time
+            std::setvbuf(m_file, nullptr, _IONBF, 0);
+            for (Buffer &buffer : m_buffers)
+            {
+                buffer.data = std::make_unique<char[]>(s_bufferSize);
+            }
+            m_writer = std::make_unique<std::thread>([this]() { write_buffers(); });
+        }
+
+        /// @brief checks whether the file has been opened
+        /// @return true if the file is open
+        bool is_open() const
+        {
+            return (m_file != nullptr);
+        }
+
+        /// @brief appends to the log (only ever called by one thread at a time)
+        /// @param data the text to append
+        /// @param size the length of the text
+        void write(const char *data, std::streamsize size)
+        {
+            if (m_file == nullptr)
+            {
+                return;
+            }
+
+            size_t remaining{static_cast<size_t>(size)};
+            while (remaining > 0)
+            {
+                Buffer      &buffer{m_buffers[m_head.load(std::memory_order_relaxed) % s_bufferCount]};
+                const size_t chunk{std::min(remaining, s_bufferSize - buffer.size)};
+                std::copy_n(data, chunk, buffer.data.get() + buffer.size);
+                buffer.size += chunk;
+                data += chunk;
+                remaining -= chunk;
+                if (buffer.size == s_bufferSize)
+                {
+                    publish();
+                }
+            }
+        }
+
+        /// @brief hands the partly filled buffer to the writer thread (without waiting for it to be written)
+        void flush()
+        {
+            if (m_file != nullptr && m_buffers[m_head.load(std::memory_order_relaxed) % s_bufferCount].size > 0)
+            {
+                publish();
+            }
+        }
+
+        /// @brief writes out everything which is buffered, then closes the file
+        void close()
+        {
+            if (m_file == nullptr)
+            {
+                return;
+            }
+            flush();
+            m_closing.store(true);
+            wake_writer();
+            m_writer->join();
+            m_writer.reset();
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+
+        /// @brief gets the time the writer thread has spent writing to the file so far
+        /// @return the time, in nanoseconds
+        long long get_write_ns() const
+        {
+            return m_writeNs.load(std::memory_order_relaxed);
+        }
+
+        /// @brief forgets about the file and the writer thread without touching them; used by forked worker processes,
+        /// where the writer thread doesn't exist (and the file belongs to the parent)
+        void abandon()
+        {
+            static_cast<void>(m_writer.release());
+            m_file = nullptr;
+        }
+
+        /// @brief writes whatever the writer thread hasn't written yet straight to the file; called if the
+        /// application crashes (or is ended by the watchdog), so the log shows what was happening at the time
+        /// @param epilogue extra text to write after everything else
+        /// @remark this is a best effort-- it doesn't synchronize with the writer thread (which may be halfway through
+        /// a buffer), and stdio isn't async-signal-safe
+        void write_unwritten(std::string_view epilogue = {}) noexcept
+        {
+            if (m_file == nullptr)
+            {
+                return;
+            }
+            // the published buffers, then the one which was being filled (unless the ring is full, in which case the
+            // reporting thread hadn't started on it yet)
+            const size_t head{m_head.load()};
+            const size_t tail{m_tail.load()};
+            for (size_t idx{tail}; idx < head; idx++)
+            {
+                const Buffer &buffer{m_buffers[idx % s_bufferCount]};
+                std::fwrite(buffer.data.get(), 1, buffer.size, m_file);
+            }
+            if (head - tail < s_bufferCount)
+            {
+                const Buffer &buffer{m_buffers[head % s_bufferCount]};
+                std::fwrite(buffer.data.get(), 1, buffer.size, m_file);
+            }
+            std::fwrite(epilogue.data(), 1, epilogue.size(), m_file);
+            std::fflush(m_file);
+        }
+
+      private:
+        /// @brief a buffer of log text
+        struct Buffer
+        {
+            std::unique_ptr<char[]> data; ///< the text (s_bufferSize bytes are allocated)
+            size_t                  size{0}; ///< how much of the buffer is used
+        };
+
+        /// @brief publishes the buffer at the head, waiting (if the ring is full) until the next one is free
+        void publish()
+        {
+            const size_t head{m_head.load(std::memory_order_relaxed) + 1};
+            m_head.store(head, std::memory_order_release);
+            wake_writer();
+
+            size_t tail{m_tail.load(std::memory_order_acquire)};
+            while (head - tail >= s_bufferCount)
+            {
+                m_tail.wait(tail, std::memory_order_acquire);
+                tail = m_tail.load(std::memory_order_acquire);
+            }
+        }
+
+        /// @brief wakes the writer thread up (it sleeps whenever there's nothing to write)
+        void wake_writer()
+        {
+            m_wakeups.fetch_add(1, std::memory_order_release);
+            m_wakeups.notify_one();
+        }
+
+        /// @brief the body of the writer thread; writes out the published buffers as they come in
+        void write_buffers()
+        {
+            size_t tail{0};
+            while (true)
+            {
+                // read the wakeup count first, so a buffer published after the head is read still wakes us up
+                const size_t wakeups{m_wakeups.load(std::memory_order_acquire)};
+                // then whether the log is closing, before the head: close() publishes the last buffer before it sets
+                // m_closing, so once that's seen, the head read after it includes the last buffer
+                const bool   closing{m_closing.load()};
+                const size_t head{m_head.load(std::memory_order_acquire)};
+                if (tail == head)
+                {
+                    if (closing)
+                    {
+                        return;
+                    }
+                    std::fflush(m_file);
+                    m_wakeups.wait(wakeups, std::memory_order_acquire);
+                    continue;
+                }
+
+                for (; tail != head; tail++)
+                {
+                    const auto writeStart{std::chrono::steady_clock::now()};
+                    Buffer    &buffer{m_buffers[tail % s_bufferCount]};
+                    std::fwrite(buffer.data.get(), 1, buffer.size, m_file);
+                    buffer.size = 0;
+                    m_writeNs.fetch_add(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                             writeStart)
+                            .count(),
+                        std::memory_order_relaxed);
+                    m_tail.store(tail + 1, std::memory_order_release);
+                    m_tail.notify_one();
+                }
+            }
+        }
+
+        static constexpr size_t s_bufferCount{8};                      ///< the number of buffers in the ring
+        static constexpr size_t s_bufferSize{bTESTS_LOG_BUFFER_SIZE}; ///< the size of each buffer
+
+        std::array<Buffer, s_bufferCount> m_buffers;
+        std::atomic<size_t>               m_head{0};    // the number of buffers published (by the reporting thread)
+        std::atomic<size_t>               m_tail{0};    // the number of buffers written (by the writer thread)
+        std::atomic<size_t>               m_wakeups{0}; // bumped whenever the writer has something to do
+        std::atomic<bool>                 m_closing{false};
+        std::atomic<long long>            m_writeNs{0}; // the time the writer thread has spent writing the buffers
+        std::FILE                        *m_file{nullptr};
+        std::unique_ptr<std::thread>      m_writer; // (heap allocated, so a forked child can abandon it)
+    };
+#    endif // !bTESTS_NO_LOG
+
+    /// @brief a queue of test indices owned by a single worker thread; other workers may steal from the back of it
+    class WorkQueue
+    {
+      public:
+        /// @brief adds a test index to the back of the queue
+        /// @param idx the index of the test to add
+        void push(size_t idx)
+        {
+            std::lock_guard lock{m_mutex};
+            m_indices.push_back(idx);
+        }
+
+        /// @brief takes a test index from the front of the queue (used by the owning worker)
+        /// @param idx set to the index of the test, if there was one
+        /// @return true if an index was taken, false if the queue was empty
+        bool pop(size_t &idx)
+        {
+            std::lock_guard lock{m_mutex};
+            if (m_indices.empty())
+            {
+                return false;
+            }
+            idx = m_indices.front();
+            m_indices.pop_front();
+            return true;
+        }
+
+        /// @brief takes a test index from the back of the queue (used by the other workers)
+        /// @param idx set to the index of the test, if there was one
+        /// @return true if an index was stolen, false if the queue was empty
+        bool steal(size_t &idx)
+        {
+            std::lock_guard lock{m_mutex};
+            if (m_indices.empty())
+            {
+                return false;
+            }
+            idx = m_indices.back();
+            m_indices.pop_back();
+            return true;
+        }
+
+      private:
+        std::mutex         m_mutex;
+        std::deque<size_t> m_indices;
+    };
+
+    /// @brief receives the results as they are reported, to write them out in a machine readable format
+    ///
+    /// the results arrive in order (on the main thread): the tests, grouped by group, then the benchmarks
+    class Reporter
+    {
+      public:
+        /// @brief opens the file to write the results to
+        /// @param path the name of the file
+        explicit Reporter(const std::string &path)
+            : m_file{path}
+        {
+        }
+
+        virtual ~Reporter() = default;
+
+        /// @brief checks whether the file could be opened
+        /// @return true if the file is open
+        bool is_open() const
+        {
+            return m_file.is_open();
+        }
+
+        /// @brief writes out anything which is buffered by the file stream
+        void flush()
+        {
+            m_file.flush();
+        }
+
+        /// @brief called once each test has finished
+        /// @param testCase the test which was run
+        /// @param result the result of the test
+        virtual void report_test(const TestCase &testCase, const TestResult &result) = 0;
+
+        /// @brief called once each benchmark has finished
+        /// @param testCase the benchmark which was run
+        /// @param result the result of the benchmark
+        /// @param stats the statistics of the benchmark's samples (zero if it failed)
+        /// @param comparison how the benchmark compared with the baseline (if "--baseline" was given)
+        virtual void report_benchmark(const TestCase &testCase, const BenchmarkResult &result,
+                                      const BenchmarkStats &stats, const BaselineComparison &comparison) = 0;
+
+        /// @brief called once everything has been reported
+        /// @param passed the number of tests which passed
+        /// @param tests the number of tests which were run
+        /// @param benchmarkFailures the number of benchmarks which failed
+        virtual void finish(size_t passed, size_t tests, size_t benchmarkFailures) = 0;
+
+      protected:
+        std::ofstream m_file; ///< the file the results are written to
+
+        /// @brief gets the name of a test status (as written by the reporters)
+        /// @param status the status
+        /// @return the name of the status
+        static const char *get_status_name(TestStatus status)
+        {
+            switch (status)
+            {
+            case TestStatus::passed:
+                return "passed";
+            case TestStatus::failed:
+                return "failed";
+            case TestStatus::crashed:
+                return "crashed";
+            case TestStatus::timed_out:
+                return "timed_out";
+            }
+            return "unknown";
+        }
+
+        /// @brief describes why a test did not pass
+        /// @param result the result of the test
+        /// @return the failure, followed by the expression (if there is one) in brackets
+        static std::string describe_failure(const TestResult &result)
+        {
+            std::string description{result.failure};
+            if (!result.expression.empty())
+            {
+                description.append(" (").append(result.expression).append(")");
+            }
+            return description;
+        }
+    };
+
+    /// @brief writes the results as JUnit XML
+    ///
+    /// each group becomes a <testsuite>; since a suite's counts are attributes, the cases of the current group are
+    /// buffered until the group changes, but nothing else is held on to. The (captured) output of a test is included
+    /// if it didn't pass
+    class JUnitReporter : public Reporter
+    {
+      public:
+        /// @brief opens the file and writes the XML header
+        /// @param path the name of the file
+        explicit JUnitReporter(const std::string &path)
+            : Reporter{path}
+        {
+            m_file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n";
+        }
+
+        void report_test(const TestCase &testCase, const TestResult &result) override
+        {
+            add_case(testCase, false, result, result.wallNs);
+        }
+
+        void report_benchmark(const TestCase &testCase, const BenchmarkResult &result, const BenchmarkStats &,
+                              const BaselineComparison &comparison) override
+        {
+            // a regression fails the run, so it's reported as a failure (even though the benchmark itself passed)
+            if (comparison.verdict == BaselineVerdict::regressed && result.result.status == TestStatus::passed)
+            {
+                TestResult regressed{result.result};
+                regressed.status     = TestStatus::failed;
+                regressed.failure    = "regressed compared with the baseline";
+                regressed.expression = format_comparison(comparison);
+                add_case(testCase, true, regressed, result.result.wallNs);
+                return;
+            }
+            add_case(testCase, true, result.result, result.result.wallNs);
+        }
+
+        void finish(size_t, size_t, size_t) override
+        {
+            write_suite();
+            m_file << "</testsuites>\n";
+            m_file.flush();
+        }
+
+      private:
+        /// @brief adds a test case to the current suite (writing out the previous suite if the group has changed)
+        /// @param testCase the test (or benchmark)
+        /// @param benchmark whether the case is a benchmark
+        /// @param result the result of the case
+        /// @param wallNs how long the case took
+        void add_case(const TestCase &testCase, bool benchmark, const TestResult &result, double wallNs)
+        {
+            if (testCase.group != m_group || benchmark != m_benchmarks)
+            {
+                write_suite();
+                m_group.assign(testCase.group);
+                m_benchmarks = benchmark;
+            }
+
+            m_cases.append("    <testcase classname=\"").append(escape(testCase.group)).append("\" name=\"");
+            m_cases.append(escape(testCase.name)).append("\" time=\"").append(format_seconds(wallNs)).append("\"");
+            m_time += wallNs;
+            m_count++;
+            if (result.status == TestStatus::passed)
+            {
+                m_cases.append("/>\n");
+                return;
+            }
+
+            // assertions are failures; crashes and timeouts are errors
+            const bool failed{result.status == TestStatus::failed};
+            failed ? m_failures++ : m_errors++;
+            m_cases.append(">\n      <").append(failed ? "failure" : "error").append(" type=\"");
+            m_cases.append(get_status_name(result.status)).append("\" message=\"");
+            m_cases.append(escape(describe_failure(result))).append("\"/>\n");
+            if (!result.log.empty())
+            {
+                m_cases.append("      <system-out>").append(escape(result.log)).append("</system-out>\n");
+            }
+            m_cases.append("    </testcase>\n");
+        }
+
+        /// @brief writes out the buffered suite (if there is one)
+        void write_suite()
+        {
+            if (m_count == 0)
+            {
+                return;
+            }
+            m_file << "  <testsuite name=\"" << escape(m_group) << (m_benchmarks ? " (benchmarks)" : "")
+                   << "\" tests=\"" << m_count << "\" failures=\"" << m_failures << "\" errors=\"" << m_errors
+                   << "\" time=\"" << format_seconds(m_time) << "\">\n"
+                   << m_cases << "  </testsuite>\n";
+            m_file.flush();
+            m_cases.clear();
+            m_count = m_failures = m_errors = 0;
+            m_time                          = 0.0;
+        }
+
+        /// @brief formats a duration in seconds (as JUnit expects)
+        /// @param ns the duration in nanoseconds
+        /// @return the formatted number of seconds
+        static std::string format_seconds(double ns)
+        {
+            char buffer[32]{};
+            std::snprintf(buffer, sizeof(buffer), "%.6f", ns / 1e9);
+            return buffer;
+        }
+
+        /// @brief escapes text for use in XML (attributes or content); control characters XML can't hold are dropped
+        /// @param text the text to escape
+        /// @return the escaped text
+        static std::string escape(std::string_view text)
+        {
+            std::string escaped;
+            escaped.reserve(text.size());
+            for (const char character : text)
+            {
+                switch (character)
+                {
+                case '&':
+                    escaped.append("&amp;");
+                    break;
+                case '<':
+                    escaped.append("&lt;");
+                    break;
+                case '>':
+                    escaped.append("&gt;");
+                    break;
+                case '"':
+                    escaped.append("&quot;");
+                    break;
+                case '\'':
+                    escaped.append("&apos;");
+                    break;
+                default:
+                    if (static_cast<unsigned char>(character) >= 0x20 || character == '\t' || character == '\n' ||
+                        character == '\r')
+                    {
+                        escaped.push_back(character);
+                    }
+                }
+            }
+            return escaped;
+        }
+
+        std::string m_group;             // the group of the suite being buffered
+        bool        m_benchmarks{false}; // whether the suite being buffered holds benchmarks
+        std::string m_cases;             // the <testcase> elements of the suite being buffered
+        size_t      m_count{0}, m_failures{0}, m_errors{0};
+        double      m_time{0.0};
+    };
+
+    /// @brief writes the results as JSON lines: one object per test (or benchmark), as each one finishes, then a
+    /// summary
+    class JsonReporter : public Reporter
+    {
+      public:
+        /// @brief opens the file
+        /// @param path the name of the file
+        explicit JsonReporter(const std::string &path)
+            : Reporter{path}
+        {
+        }
+
+        void report_test(const TestCase &testCase, const TestResult &result) override
+        {
+            std::string line{"{\"type\":\"test\""};
+            append_case(line, testCase, result);
+            line.append("}\n");
+            write(line, testCase.group);
+        }
+
+        void report_benchmark(const TestCase &testCase, const BenchmarkResult &result, const BenchmarkStats &stats,
+                              const BaselineComparison &comparison) override
+        {
+            std::string line{"{\"type\":\"benchmark\""};
+            append_case(line, testCase, result.result);
+            line.append(",\"iterations\":").append(std::to_string(result.iterations));
+            line.append(",\"samples\":").append(std::to_string(result.samples.size()));
+            line.append(",\"min_ns\":").append(format_number(stats.min));
+            line.append(",\"median_ns\":").append(format_number(stats.median));
+            line.append(",\"mean_ns\":").append(format_number(stats.mean));
+            line.append(",\"stddev_ns\":").append(format_number(stats.stddev));
+            append_counters(line, result.counters, static_cast<double>(result.iterations * result.samples.size()),
+                            "_per_op");
+            if (comparison.verdict != BaselineVerdict::none)
+            {
+                constexpr const char *verdicts[]{"none", "unchanged", "improved", "regressed"};
+                line.append(",\"baseline\":\"").append(verdicts[static_cast<int>(comparison.verdict)]).append("\"");
+                line.append(",\"baseline_change_percent\":").append(format_number(comparison.change));
+                char buffer[32]{};
+                std::snprintf(buffer, sizeof(buffer), "%.3g", comparison.p);
+                line.append(",\"baseline_p\":").append(buffer);
+            }
+            line.append("}\n");
+            write(line, testCase.group);
+        }
+
+        void finish(size_t passed, size_t tests, size_t benchmarkFailures) override
+        {
+            m_file << "{\"type\":\"summary\",\"passed\":" << passed << ",\"tests\":" << tests
+                   << ",\"benchmark_failures\":" << benchmarkFailures << "}\n";
+            m_file.flush();
+        }
+
+      private:
+        /// @brief writes a line, flushing the file whenever a group finishes
+        /// @param line the line to write
+        /// @param group the group of the test the line describes
+        void write(const std::string &line, std::string_view group)
+        {
+            if (group != m_group)
+            {
+                m_file.flush();
+                m_group.assign(group);
+            }
+            m_file.write(line.data(), static_cast<std::streamsize>(line.size()));
+        }
+
+        /// @brief appends the fields every test and benchmark has
+        /// @param line the line to append to
+        /// @param testCase the test (or benchmark)
+        /// @param result the result of the test
+        static void append_case(std::string &line, const TestCase &testCase, const TestResult &result)
+        {
+            line.append(",\"group\":").append(quote(testCase.group));
+            line.append(",\"name\":").append(quote(testCase.name));
+            line.append(",\"status\":\"").append(get_status_name(result.status)).append("\"");
+            if (result.status != TestStatus::passed)
+            {
+                line.append(",\"failure\":").append(quote(describe_failure(result)));
+                line.append(",\"failures\":").append(std::to_string(std::max<size_t>(result.failures, 1)));
+            }
+            line.append(",\"wall_ns\":").append(format_number(result.wallNs));
+            line.append(",\"cpu_ns\":").append(format_number(result.cpuNs));
+#    ifdef bTESTS_TRACK_ALLOCATIONS
+            line.append(",\"allocations\":").append(std::to_string(result.allocations));
+            line.append(",\"allocated_bytes\":").append(std::to_string(result.allocatedBytes));
+            line.append(",\"peak_bytes\":").append(std::to_string(result.peakBytes));
+            line.append(",\"leaked_bytes\":").append(std::to_string(result.leakedBytes));
+#    endif // bTESTS_TRACK_ALLOCATIONS
+            append_counters(line, result.counters, 1.0, "");
+            if (result.runs > 1)
+            {
+                line.append(",\"runs\":").append(std::to_string(result.runs));
+                line.append(",\"failed_runs\":").append(std::to_string(result.failedRuns));
+                line.append(",\"min_run_ns\":").append(format_number(result.minRunNs));
+                line.append(",\"mean_run_ns\":").append(format_number(result.meanRunNs));
+                line.append(",\"max_run_ns\":").append(format_number(result.maxRunNs));
+            }
+        }
+
+        /// @brief appends the hardware events counted by a test (or benchmark) to a JSON object (if any were)
+        /// @param line the JSON object (so far)
+        /// @param values the counted events
+        /// @param operations what to divide the counts by (the number of iterations, for a benchmark)
+        /// @param suffix appended to each key (e.g. "_per_op")
+        static void append_counters(std::string &line, const CounterValues &values, double operations,
+                                    std::string_view suffix)
+        {
+            const auto append = [&](unsigned event, std::string_view key, double value) {
+                if ((values.events & event) != 0 && operations > 0.0)
+                {
+                    char buffer[32]{};
+                    std::snprintf(buffer, sizeof(buffer), "%.3f", value / operations);
+                    line.append(",\"").append(key).append(suffix).append("\":").append(buffer);
+                }
+            };
+            const bool tsc{(values.events & CounterValues::tscEvent) != 0};
+            append(CounterValues::cyclesEvent, tsc ? "tsc_ticks" : "cycles", values.cycles);
+            append(CounterValues::instructionsEvent, "instructions", values.instructions);
+            append(CounterValues::cacheMissesEvent, "cache_misses", values.cacheMisses);
+            append(CounterValues::branchMissesEvent, "branch_misses", values.branchMisses);
+            if ((values.events & CounterValues::instructionsEvent) != 0 && values.cycles > 0.0)
+            {
+                char buffer[32]{};
+                std::snprintf(buffer, sizeof(buffer), "%.3f", values.instructions / values.cycles);
+                line.append(",\"ipc\":").append(buffer);
+            }
+        }
+
+        /// @brief formats a number for JSON
+        /// @param value the number
+        /// @return the formatted number (to the nearest tenth)
+        static std::string format_number(double value)
+        {
+            char buffer[32]{};
+            std::snprintf(buffer, sizeof(buffer), "%.1f", value);
+            return buffer;
+        }
+
+        /// @brief quotes (and escapes) text as a JSON string
+        /// @param text the text to quote
+        /// @return the JSON string
+        static std::string quote(std::string_view text)
+        {
+            std::string quoted{"\""};
+            for (const char character : text)
+            {
+                if (character == '"' || character == '\\')
+                {
+                    quoted.push_back('\\');
+                    quoted.push_back(character);
+                }
+                else if (static_cast<unsigned char>(character) < 0x20)
+                {
+                    char buffer[8]{};
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(character));
+                    quoted.append(buffer);
+                }
+                else
+                {
+                    quoted.push_back(character);
+                }
+            }
+            return quoted.append("\"");
+        }
+
+        std::string m_group; // the group of the last line written
+    };
+
+    //--Implementation Variables----------------------------------------------------------------------------------------
+
+    // we only need the log file variable if we're making use of the log file
+#    ifndef bTESTS_NO_LOG
+    /// @brief the output (logging) file; only opened once something is written to it (see get_tests_log())
+    static AsyncLog g_testsLog{};
+#    endif // !bTESTS_NO_LOG
+
+    /// @brief keep track of the number of successes; incremeneted whenever a test passes (from any thread)
+    static std::atomic<size_t> g_successes{0};
+
+    /// @brief keep track of the number of benchmarks which failed (benchmarks only run on the main thread)
+    static size_t g_benchmarkFailures{0};
+
+    /// @brief the number of tests which have failed so far (counted as they finish, from any thread)
+    static std::atomic<size_t> g_failuresSoFar{0};
+
+    /// @brief set once enough tests have failed that no more should be started (see "--fail-fast")
+    static std::atomic<bool> g_stopStarting{false};
+
+    /// @brief the number of tests which weren't run because the run stopped early (see "--fail-fast")
+    static size_t g_testsNotRun{0};
+
+    /// @brief the baseline the benchmarks are compared with (only read if "--baseline" is given)
+    static Baseline g_baseline{};
+
+    /// @brief how each benchmark compared with the baseline (indexed like get_benchmark_cases())
+    static std::vector<BaselineComparison> g_comparisons{};
+
+    /// @brief the samples of each benchmark (indexed like get_benchmark_cases()), kept if "--save-baseline" is given
+    static std::vector<std::vector<double>> g_benchmarkSamples{};
+
+    /// @brief the options for this run of the tests
+    static Options g_options{};
+
+    /// @brief the time taken by each test (indexed like get_test_cases()); filled in as the results are reported
+    static std::vector<TestTiming> g_timings{};
+
+    /// @brief what this run appends to the trend file (only kept if there is one; see "--trend-file")
+    static std::vector<TrendRecord> g_trendRecords{};
+
+    /// @brief the history read from the history file (if any); updated with the results of this run at the end
+    static History g_history{};
+
+    /// @brief the history used to balance the shards (only read if "--shard-timings" is given)
+    static History g_shardTimings{};
+
+    /// @brief the machine readable reporters which were asked for on the command line
+    static std::vector<std::unique_ptr<Reporter>> g_reporters{};
+
+    /// @brief the time (in nanoseconds, summed over every thread) spent in each phase of the run, indexed by
+    /// RunnerPhase; only measured with "--profile-runner"
+    static std::array<std::atomic<long long>, static_cast<size_t>(RunnerPhase::count)> g_phaseNs{};
+
+    //--Implementation Methods------------------------------------------------------------------------------------------
+
+    /// @brief times a phase of the run (see "--profile-runner") for as long as it's in scope; does nothing otherwise
+    ///
+    /// the timers on a thread nest, and each phase only counts its own time: a timer pauses the one it's nested in
+    /// (e.g. the test body pauses the capture around it) until it goes out of scope
+    class PhaseTimer
+    {
+      public:
+        /// @brief starts timing a phase on the calling thread
+        /// @param phase the phase
+        explicit PhaseTimer(RunnerPhase phase) : m_phase{phase}
+        {
+            if (!g_options.profileRunner)
+            {
+                return;
+            }
+            m_start = std::chrono::steady_clock::now();
+            m_outer = active();
+            if (m_outer != nullptr)
+            {
+                m_outer->add_elapsed(m_start);
+            }
+            active() = this;
+        }
+
+        PhaseTimer(const PhaseTimer &)            = delete;
+        PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+        /// @brief adds the time since the timer started (or was resumed) to its phase, and resumes the outer timer
+        ~PhaseTimer()
+        {
+            if (active() != this)
+            {
+                return;
+            }
+            const std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+            add_elapsed(now);
+            active() = m_outer;
+            if (m_outer != nullptr)
+            {
+                m_outer->m_start = now;
+            }
+        }
+
+      private:
+        /// @brief adds the time from the start (or the last resume) until now to the phase
+        /// @param now the time now
+        void add_elapsed(std::chrono::steady_clock::time_point now)
+        {
+            g_phaseNs[static_cast<size_t>(m_phase)].fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count(), std::memory_order_relaxed);
+        }
+
+        /// @brief gets the innermost timer which is running on the calling thread
+        /// @return the timer (nullptr if there isn't one)
+        static PhaseTimer *&active()
+        {
+            thread_local PhaseTimer *s_active{nullptr};
+            return s_active;
+        }
+
+        RunnerPhase                           m_phase;           ///< the phase being timed
+        std::chrono::steady_clock::time_point m_start;           ///< when the timer started (or was last resumed)
+        PhaseTimer                           *m_outer{nullptr}; ///< the timer this one is nested in (if any)
+    };
+
+    /// @brief parses a non-negative, possibly fractional, number (a number of seconds, or a percentage)
+    /// @param text the text to parse
+    /// @param number set to the parsed value if the text is a valid number
+    /// @return true if the text was a valid number, false otherwise
+    bool parse_decimal(std::string_view text, double &number)
+    {
+        const std::string copy{text}; // strtod needs a null terminated string
+        char             *end{nullptr};
+        const double      value{std::strtod(copy.c_str(), &end)};
+        if (copy.empty() || end != copy.c_str() + copy.size() || !(value >= 0.0))
+        {
+            return false;
+        }
+        number = value;
+        return true;
+    }
+
+    /// @brief looks up one of the attributes of a test
+    /// @param attributes the attributes of the test (comma or space separated "key=value" pairs, or just "key")
+    /// @param key the name of the attribute
+    /// @param value set to the value of the attribute (empty if it doesn't have one), if the test has it
+    /// @return true if the test has the attribute
+    bool find_attribute(std::string_view attributes, std::string_view key, std::string_view &value)
+    {
+        while (!attributes.empty())
+        {
+            const size_t separator{std::min(attributes.find_first_of(", "), attributes.size())};
+            const std::string_view attribute{attributes.substr(0, separator)};
+            attributes.remove_prefix(std::min(separator + 1, attributes.size()));
+
+            const size_t equals{std::min(attribute.find('='), attribute.size())};
+            if (attribute.substr(0, equals) == key)
+            {
+                value = attribute.substr(std::min(equals + 1, attribute.size()));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief fills in the settings of a test from its attributes
+    /// @param testCase the test
+    void parse_attributes(TestCase &testCase)
+    {
+        std::string_view value;
+        if (find_attribute(testCase.attributes, "timeout", value) && !parse_decimal(value, testCase.timeout))
+        {
+            std::cout << "ERROR:\tIgnoring the invalid timeout '" << value << "' of '" << testCase.group << "' / '"
+                      << testCase.name << "'.\n";
+        }
+
+        testCase.exclusive = find_attribute(testCase.attributes, "exclusive", value);
+        if (find_attribute(testCase.attributes, "threads", value))
+        {
+            const auto [end, error]{std::from_chars(value.data(), value.data() + value.size(), testCase.threads)};
+            if (error != std::errc{} || end != value.data() + value.size() || testCase.threads == 0)
+            {
+                std::cout << "ERROR:\tIgnoring the invalid thread count '" << value << "' of '" << testCase.group
+                          << "' / '" << testCase.name << "'.\n";
+                testCase.threads = 0;
+            }
+        }
+    }
+
+    /// @brief gets every registered test and benchmark, sorted by group and then by name
+    /// @return the (static) sorted list of tests and benchmarks
+    /// @remark the list is built (and sorted) once, the first time this is called-- so it must not be called until all
+    /// of the tests have been registered (i.e. not during static initialization)
+    const std::vector<TestCase> &get_registered_cases()
+    {
+        static const std::vector<TestCase> s_registeredCases{[]() {
+            const PhaseTimer timer{RunnerPhase::registration};
+
+            // the registrations in the linker section (if any), in the order they were linked
+            const ben::tests::detail::Registration *const *sectionStart{nullptr};
+            const ben::tests::detail::Registration *const *sectionEnd{nullptr};
+#    ifdef bTESTS_USE_LINKER_SECTION
+            sectionStart = __start_bTESTS_registrations;
+            sectionEnd   = __stop_bTESTS_registrations;
+#    endif // bTESTS_USE_LINKER_SECTION
+
+            size_t count{static_cast<size_t>(sectionEnd - sectionStart)};
+            for (const auto *registration{ben::tests::detail::g_registrations}; registration != nullptr;
+                 registration = registration->next)
+            {
+                count++;
+            }
+
+            std::vector<TestCase> testCases;
+            testCases.reserve(count);
+            const auto add = [&testCases](const ben::tests::detail::Registration &registration) {
+                testCases.push_back(TestCase{
+                    registration.group,
+                    registration.name,
+                    registration.test,
+                    registration.benchmark,
+                    registration.attributes,
+                    0.0,
+                    registration.fingerprint,
+                    registration.asyncTest});
+                parse_attributes(testCases.back());
+            };
+            for (const auto *registration{ben::tests::detail::g_registrations}; registration != nullptr;
+                 registration = registration->next)
+            {
+                add(*registration);
+            }
+            // later registrations come first (like the list), skipping any padding the linker left between them
+            for (const ben::tests::detail::Registration *const *entry{sectionEnd}; entry != sectionStart; entry--)
+            {
+                if (entry[-1] != nullptr)
+                {
+                    add(*entry[-1]);
+                }
+            }
+
+            // the list holds the most recent registration first, so a stable sort followed by removing duplicates
+            // means that (just like before) a later registration of the same group and name replaces the earlier one
+            std::stable_sort(testCases.begin(), testCases.end(), [](const TestCase &lhs, const TestCase &rhs) {
+                return (lhs.group != rhs.group ? lhs.group < rhs.group : lhs.name < rhs.name);
+            });
+            testCases.erase(
+                std::unique(
+                    testCases.begin(),
+                    testCases.end(),
+                    [](const TestCase &lhs, const TestCase &rhs) {
+                        return lhs.group == rhs.group && lhs.name == rhs.name;
+                    }),
+                testCases.end());
+            return testCases;
+        }()};
+        return s_registeredCases;
+    }
+
+#    ifndef bTESTS_NO_LOG
+    /// @brief the signals which mean the application has crashed
+    constexpr int g_crashSignals[]{SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+
+    /// @brief signal handler; writes out the rest of the log, then lets the signal kill the application as usual
+    /// @param signal the signal which was raised
+    void write_log_on_crash(int signal)
+    {
+        g_testsLog.write_unwritten();
+        std::signal(signal, SIG_DFL);
+        std::raise(signal);
+    }
+
+    /// @brief gets the log file, opening it the first time it's needed (so listing the tests doesn't overwrite it)
+    /// @return the log file
+    /// @remark the log is only written to by the main thread
+    AsyncLog &get_tests_log()
+    {
+        if (!g_testsLog.is_open())
+        {
+            g_testsLog.open(bTESTS_LOG_FILE);
+            for (const int signal : g_crashSignals)
+            {
+                std::signal(signal, write_log_on_crash);
+            }
+        }
+        return g_testsLog;
+    }
+#    endif // !bTESTS_NO_LOG
+
+    /// @brief matches some text against a glob pattern ('*' matches any run of characters, '?' any single character)
+    /// @param pattern the glob pattern
+    /// @param text the text to match
+    /// @return true if the whole of the text matches the pattern
+    bool matches_glob(std::string_view pattern, std::string_view text)
+    {
+        // match greedily, backtracking to the last '*' whenever the rest of the pattern fails to match
+        size_t patternIdx{0}, textIdx{0};
+        size_t starIdx{std::string_view::npos}, starTextIdx{0};
+        while (textIdx < text.size())
+        {
+            if (patternIdx < pattern.size() && (pattern[patternIdx] == '?' || pattern[patternIdx] == text[textIdx]))
+            {
+                patternIdx++;
+                textIdx++;
+            }
+            else if (patternIdx < pattern.size() && pattern[patternIdx] == '*')
+            {
+                starIdx     = patternIdx++;
+                starTextIdx = textIdx;
+            }
+            else if (starIdx != std::string_view::npos)
+            {
+                patternIdx = starIdx + 1;
+                textIdx    = ++starTextIdx;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        while (patternIdx < pattern.size() && pattern[patternIdx] == '*')
+        {
+            patternIdx++;
+        }
+        return (patternIdx == pattern.size());
+    }
+
+    /// @brief checks some text against a list of filters
+    /// @param filters the glob patterns; patterns starting with '-' exclude whatever they match
+    /// @param text the text to check
+    /// @return true if the text matches at least one of the (including) patterns, or there aren't any, and none of the
+    /// excluding patterns
+    bool passes_filters(const std::vector<std::string> &filters, std::string_view text)
+    {
+        bool hasIncludes{false}, included{false};
+        for (const std::string &filter : filters)
+        {
+            if (filter.starts_with('-'))
+            {
+                if (matches_glob(std::string_view{filter}.substr(1), text))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                hasIncludes = true;
+                included    = included || matches_glob(filter, text);
+            }
+        }
+        return (!hasIncludes || included);
+    }
+
+    /// @brief adds a (comma separated) list of filters to some filters
+    /// @param list the list of glob patterns
+    /// @param filters the filters to add the patterns to
+    void add_filters(std::string_view list, std::vector<std::string> &filters)
+    {
+        while (!list.empty())
+        {
+            const size_t comma{std::min(list.find(','), list.size())};
+            if (comma > 0)
+            {
+                filters.emplace_back(list.substr(0, comma));
+            }
+            list.remove_prefix(std::min(comma + 1, list.size()));
+        }
+    }
+
+    /// @brief gets the registered cases which pass the name and group filters
+    /// @return the (static) list of selected cases, in the same order as get_registered_cases()
+    /// @remark relies on the options, so it must not be called before the command line has been parsed
+    const std::vector<TestCase> &get_selected_cases()
+    {
+        static const std::vector<TestCase> s_selectedCases{[]() {
+            const PhaseTimer      timer{RunnerPhase::scheduling};
+            std::vector<TestCase> selectedCases;
+            for (const TestCase &testCase : get_registered_cases())
+            {
+                if (passes_filters(g_options.nameFilters, testCase.name) &&
+                    passes_filters(g_options.groupFilters, testCase.group))
+                {
+                    selectedCases.push_back(testCase);
+                }
+            }
+            return selectedCases;
+        }()};
+        return s_selectedCases;
+    }
+
+    /// @brief hashes the group and name of a test (64 bit FNV-1a), so it lands in the same shard on every machine
+    /// @param testCase the test to hash
+    /// @return the hash of the test
+    uint64_t hash_test_case(const TestCase &testCase)
+    {
+        uint64_t   hash{14695981039346656037ull};
+        const auto combine = [&hash](std::string_view text) {
+            for (const char character : text)
+            {
+                hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ull;
+            }
+        };
+        combine(testCase.group);
+        combine(std::string_view{"\0", 1}); // so "ab"/"c" and "a"/"bc" hash differently
+        combine(testCase.name);
+        return hash;
+    }
+
+    /// @brief gets the key of a test in the history
+    /// @param group the group of the test
+    /// @param name the name of the test
+    /// @return the group and name of the test, separated by a null character
+    std::string get_history_key(std::string_view group, std::string_view name)
+    {
+        return std::string{group}.append(1, '\0').append(name);
+    }
+
+    /// @brief gets the key of a test in the history
+    /// @param testCase the test
+    /// @return the group and name of the test, separated by a null character
+    std::string get_history_key(const TestCase &testCase)
+    {
+        return get_history_key(testCase.group, testCase.name);
+    }
+
+    /// @brief estimates how long each test will take, from the timings in a history
+    /// @param testCases the tests to estimate
+    /// @param history the history of a previous run
+    /// @return the estimated wall time of each test in nanoseconds (tests missing from the history are assumed to take
+    /// the average time of the others, and every test is assumed to take at least 1 ns so that untimed tests still get
+    /// spread out)
+    std::vector<double> estimate_durations(const std::vector<TestCase> &testCases, const History &history)
+    {
+        std::vector<double> estimates(testCases.size(), 0.0);
+        double              total{0.0};
+        size_t              known{0};
+        for (size_t idx{0}; idx < testCases.size(); idx++)
+        {
+            const auto entry{history.find(get_history_key(testCases[idx]))};
+            if (entry != history.end())
+            {
+                estimates[idx] = static_cast<double>(entry->second.wallNs);
+                total += estimates[idx];
+                known++;
+            }
+            else
+            {
+                estimates[idx] = -1.0;
+            }
+        }
+
+        const double average{known == 0 ? 1.0 : total / static_cast<double>(known)};
+        for (double &estimate : estimates)
+        {
+            estimate = (estimate < 0.0 ? average : std::max(estimate, 1.0));
+        }
+        return estimates;
+    }
+
+    /// @brief sorts the indices of some tests so the slowest (by their estimated duration) come first
+    /// @param estimates the estimated duration of each test
+    /// @return the indices of the tests, slowest first (ties keep their original order)
+    std::vector<size_t> order_slowest_first(const std::vector<double> &estimates)
+    {
+        std::vector<size_t> order(estimates.size());
+        for (size_t idx{0}; idx < order.size(); idx++)
+        {
+            order[idx] = idx;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&estimates](size_t lhs, size_t rhs) { return estimates[lhs] > estimates[rhs]; });
+        return order;
+    }
+
+    /// @brief works out which shard each selected case belongs to
+    /// @return the shard of each case (indexed like get_selected_cases())
+    ///
+    /// without shard timings, each case goes to the shard picked by its hash. With them, the tests are packed into the
+    /// shards longest first, each going to the shard with the least (estimated) work so far-- every machine reads the
+    /// same timings, so they all agree on the split. Benchmarks are always sharded by hash
+    std::vector<size_t> assign_shards()
+    {
+        const std::vector<TestCase> &selectedCases{get_selected_cases()};
+        std::vector<size_t>          shards(selectedCases.size(), 0);
+        std::vector<TestCase>        tests;
+        std::vector<size_t>          testIndices;
+        for (size_t idx{0}; idx < selectedCases.size(); idx++)
+        {
+            shards[idx] = static_cast<size_t>(hash_test_case(selectedCases[idx]) % g_options.totalShards);
+            if (selectedCases[idx].benchmark == nullptr)
+            {
+                tests.push_back(selectedCases[idx]);
+                testIndices.push_back(idx);
+            }
+        }
+
+        if (g_options.shardTimingsFile.empty())
+        {
+            return shards;
+        }
+
+        const std::vector<double> estimates{estimate_durations(tests, g_shardTimings)};
+        std::vector<double>       loads(g_options.totalShards, 0.0);
+        for (const size_t idx : order_slowest_first(estimates))
+        {
+            const size_t shard{static_cast<size_t>(std::min_element(loads.begin(), loads.end()) - loads.begin())};
+            shards[testIndices[idx]] = shard;
+            loads[shard] += estimates[idx];
+        }
+        return shards;
+    }
+
+    /// @brief checks whether a selected case belongs to the shard being run
+    /// @param idx the index of the case (in get_selected_cases())
+    /// @return true if the case should be run by this shard
+    bool is_in_shard(size_t idx)
+    {
+        if (g_options.totalShards <= 1)
+        {
+            return true;
+        }
+        static const std::vector<size_t> s_shards{assign_shards()};
+        return (s_shards[idx] == g_options.shardIndex);
+    }
+
+    /// @brief checks whether a test can be skipped because of the cache (see "--cache")
+    /// @param testCase the test to check
+    /// @return true if the history says the test passed last time it ran, and its translation unit hasn't been rebuilt
+    /// since (a test without a fingerprint is never skipped)
+    bool is_cached(const TestCase &testCase)
+    {
+        if (!g_options.cache || testCase.fingerprint == 0 || testCase.benchmark != nullptr)
+        {
+            return false;
+        }
+        const auto entry{g_history.find(get_history_key(testCase))};
+        return (entry != g_history.end() && entry->second.status == TestStatus::passed &&
+                entry->second.fingerprint == testCase.fingerprint);
+    }
+
+    /// @brief the number of tests (in this shard) which were skipped because of the cache
+    static size_t g_cachedTests{0};
+
+    /// @brief checks whether a test didn't pass in the run recorded by the history (see "--failed-first")
+    /// @param testCase the test to check
+    /// @return true if the history has the test, and it failed (crashed, or timed out)
+    bool failed_last_time(const TestCase &testCase)
+    {
+        const auto entry{g_history.find(get_history_key(testCase))};
+        return (entry != g_history.end() && entry->second.status != TestStatus::passed);
+    }
+
+    /// @brief shuffles the groups of some tests, and the tests within each group, with the seed in the options
+    /// @param testCases the tests (each group's tests next to each other); each group stays together, so its fixtures
+    /// are still only set up once
+    /// @remark the shuffles are written out (Fisher-Yates, drawing from a std::mt19937_64, whose output the standard
+    /// defines) rather than using std::shuffle, whose results differ between standard libraries
+    void shuffle_test_cases(std::vector<TestCase> &testCases)
+    {
+        std::mt19937_64 engine{static_cast<uint64_t>(g_options.seed)};
+        const auto      shuffle = [&engine](auto first, auto last) {
+            for (auto count{last - first}; count > 1; count--)
+            {
+                std::iter_swap(first + (count - 1), first + static_cast<std::ptrdiff_t>(engine() % count));
+            }
+        };
+
+        // split the tests into their groups, shuffle the groups, then the tests within each of them
+        std::vector<std::vector<TestCase>> groups;
+        for (const TestCase &testCase : testCases)
+        {
+            if (groups.empty() || groups.back().front().group != testCase.group)
+            {
+                groups.emplace_back();
+            }
+            groups.back().push_back(testCase);
+        }
+        shuffle(groups.begin(), groups.end());
+
+        testCases.clear();
+        for (std::vector<TestCase> &group : groups)
+        {
+            shuffle(group.begin(), group.end());
+            testCases.insert(testCases.end(), group.begin(), group.end());
+        }
+    }
+
+    /// @brief picks either the tests or the benchmarks (in this shard) out of the selected cases, in the order they are
+    /// run in
+    /// @param benchmarks whether to collect the benchmarks (true) or the tests (false)
+    /// @return the list of tests or benchmarks (without the tests skipped by the cache, which are counted instead)
+    /// @remark relies on the options, so it must not be called before the command line has been parsed
+    std::vector<TestCase> collect_test_cases(bool benchmarks)
+    {
+        const PhaseTimer      timer{RunnerPhase::scheduling};
+        std::vector<TestCase> testCases;
+        for (size_t idx{0}; idx < get_selected_cases().size(); idx++)
+        {
+            const TestCase &testCase{get_selected_cases()[idx]};
+            if ((testCase.benchmark != nullptr) != benchmarks || !is_in_shard(idx))
+            {
+                continue;
+            }
+            if (is_cached(testCase))
+            {
+                g_cachedTests++;
+                continue;
+            }
+            testCases.push_back(testCase);
+        }
+
+        if (!benchmarks && g_options.shuffle)
+        {
+            shuffle_test_cases(testCases);
+        }
+
+        // bring the groups with a failure (and the failed tests within them) to the front, keeping each group together
+        if (!benchmarks && g_options.failedFirst)
+        {
+            std::set<std::string_view>             failedGroups;
+            std::map<std::string_view, size_t>     groupRanks; // the position of each group, to keep them in order
+            for (const TestCase &testCase : testCases)
+            {
+                if (failed_last_time(testCase))
+                {
+                    failedGroups.insert(testCase.group);
+                }
+                groupRanks.emplace(testCase.group, groupRanks.size());
+            }
+            // the stable sort keeps the (possibly shuffled) order of the tests within each key
+            const auto comesFirst = [&](const TestCase &lhs, const TestCase &rhs) {
+                return std::tuple{failedGroups.count(lhs.group) == 0, groupRanks[lhs.group], !failed_last_time(lhs)} <
+                       std::tuple{failedGroups.count(rhs.group) == 0, groupRanks[rhs.group], !failed_last_time(rhs)};
+            };
+            std::stable_sort(testCases.begin(), testCases.end(), comesFirst);
+        }
+        return testCases;
+    }
+
+    /// @brief gets the tests flattened into a single list, in the order they are run (and reported) in
+    /// @return the (static) list of tests
+    /// @remark the same caveats as get_registered_cases() apply
+    const std::vector<TestCase> &get_test_cases()
+    {
+        static const std::vector<TestCase> s_testCases{collect_test_cases(false)};
+        return s_testCases;
+    }
+
+    /// @brief gets the benchmarks flattened into a single list, in the order they are run (and reported) in
+    /// @return the (static) list of benchmarks
+    /// @remark the same caveats as get_test_cases() apply
+    const std::vector<TestCase> &get_benchmark_cases()
+    {
+        static const std::vector<TestCase> s_benchmarkCases{collect_test_cases(true)};
+        return s_benchmarkCases;
+    }
+
+    /// @brief convenience function; prints an 80 char long dashed line to the output
+    void print_line_separator()
+    {
+        std::cout << "--------------------------------------------------------------------------------\n";
+    };
+
+    /// @brief gets the total number of tests (not including benchmarks)
+    /// @return the total number of tests
+    size_t get_number_of_tests()
+    {
+        return get_test_cases().size();
+    }
+
+    /// @brief checks whether each test runs more than once (see "--repeat", "--repeat-until-fail", and "--stress")
+    /// @return true if it does
+    bool is_repeating()
+    {
+        return g_options.repeat > 1 || g_options.repeatUntilFail || g_options.stress > 1;
+    }
+
+    /// @brief gets the number of async (coroutine) tests
+    /// @return the number of async tests
+    size_t get_number_of_async_tests()
+    {
+        const std::vector<TestCase> &testCases{get_test_cases()};
+        return static_cast<size_t>(std::count_if(testCases.begin(), testCases.end(), [](const TestCase &testCase) {
+            return testCase.asyncTest != nullptr;
+        }));
+    }
+
+    /// @brief gets the number of groups which contain at least one test
+    /// @return the number of groups
+    size_t get_number_of_groups()
+    {
+        size_t groups{0};
+        for (size_t idx{0}; idx < get_test_cases().size(); idx++)
+        {
+            if (idx == 0 || get_test_cases()[idx - 1].group != get_test_cases()[idx].group)
+            {
+                groups++;
+            }
+        }
+        return groups;
+    }
+
+    /// @brief gets the number of benchmarks which will be run
+    /// @return the number of benchmarks (0 if the benchmarks are disabled)
+    size_t get_number_of_benchmarks()
+    {
+        return (g_options.benchmarks ? get_benchmark_cases().size() : 0);
+    }
+
+    /// @brief parses a (non-negative) number from a command line argument
+    /// @param arg the argument to parse
+    /// @param value set to the parsed value if the argument is a valid number
+    /// @return true if the argument was a valid number, false otherwise
+    bool parse_number(std::string_view arg, size_t &value)
+    {
+        const auto [end, error]{std::from_chars(arg.data(), arg.data() + arg.size(), value)};
+        return (error == std::errc{} && end == arg.data() + arg.size());
+    }
+
+    /// @brief parses a (non-negative) number from an environment variable, if it is set
+    /// @param name the name of the environment variable
+    /// @param value set to the parsed value if the variable is set
+    /// @return true if the variable is unset (or empty) or a valid number, false otherwise
+    bool parse_environment(const char *name, size_t &value)
+    {
+#    ifdef _MSC_VER
+#        pragma warning(suppress : 4996) // nothing modifies the environment while it's read, so getenv is fine
+#    endif                               // _MSC_VER
+        const char *const variable{std::getenv(name)};
+        if (variable == nullptr || *variable == '\0')
+        {
+            return true;
+        }
+        if (!parse_number(variable, value))
+        {
+            std::cout << "ERROR:\tThe environment variable '" << name << "' expects a number.\n";
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief parses the command line arguments (and the sharding environment variables) into g_options
+    /// @param argc the number of command line arguments
+    /// @param argv the command line arguments
+    /// @return true if all of the arguments were understood, false otherwise
+    /// @remark the command line takes priority over the environment variables
+    bool parse_arguments(int argc, char *argv[])
+    {
+        if (!parse_environment("bTESTS_SHARD_INDEX", g_options.shardIndex) ||
+            !parse_environment("bTESTS_TOTAL_SHARDS", g_options.totalShards))
+        {
+            return false;
+        }
+
+        for (int idx{1}; idx < argc; idx++)
+        {
+            const std::string_view arg{argv[idx]};
+
+            if (arg == "--jobs" || arg == "-j")
+            {
+                if (idx + 1 >= argc || !parse_number(argv[idx + 1], g_options.jobs))
+                {
+                    std::cout << "ERROR:\t'" << arg << "' expects a number of worker threads.\n";
+                    return false;
+                }
+                g_options.jobsGiven = true;
+                idx++;
+            }
+            else if (arg.starts_with("--jobs="))
+            {
+                if (!parse_number(arg.substr(7), g_options.jobs))
+                {
+                    std::cout << "ERROR:\t'--jobs' expects a number of worker threads.\n";
+                    return false;
+                }
+                g_options.jobsGiven = true;
+            }
+            else if (arg == "--slowest")
+            {
+                if (idx + 1 >= argc || !parse_number(argv[idx + 1], g_options.slowest))
+                {
+                    std::cout << "ERROR:\t'--slowest' expects a number of tests.\n";
+                    return false;
+                }
+                idx++;
+            }
+            else if (arg == "--no-benchmarks")
+            {
+                g_options.benchmarks = false;
+            }
+            else if (arg == "--counters")
+            {
+                g_options.counters = true;
+            }
+            else if (arg == "--quiet" || arg == "-q")
+            {
+                g_options.quiet = true;
+            }
+            else if (arg == "--profile-runner")
+            {
+                g_options.profileRunner = true;
+            }
+            else if (arg == "--baseline" || arg == "--save-baseline")
+            {
+                if (idx + 1 >= argc)
+                {
+                    std::cout << "ERROR:\t'" << arg << "' expects the name of a baseline file.\n";
+                    return false;
+                }
+                (arg == "--baseline" ? g_options.baselineFile : g_options.saveBaselineFile) = argv[++idx];
+            }
+            else if (arg == "--trend-file" || arg == "--trend-tag" || arg == "--trend")
+            {
+                if (idx + 1 >= argc)
+                {
+                    std::cout << "ERROR:\t'" << arg << "' expects "
+                              << (arg == "--trend-file" ? "the name of a trend file"
+                                  : arg == "--trend-tag" ? "a tag (e.g. a commit hash)"
+                                                         : "a pattern matching the names of some tests")
+                              << ".\n";
+                    return false;
+                }
+                (arg == "--trend-file"  ? g_options.trendFile
+                 : arg == "--trend-tag" ? g_options.trendTag
+                                        : g_options.trendPattern) = argv[++idx];
+            }
+            else if (arg == "--regression-threshold")
+            {
+                if (idx + 1 >= argc || !parse_decimal(argv[idx + 1], g_options.regressionThreshold))
+                {
+                    std::cout << "ERROR:\t'--regression-threshold' expects a (non-negative) percentage.\n";
+                    return false;
+                }
+                idx++;
+            }
+            else if (arg == "--isolate")
+            {
+                g_options.isolate = true;
+            }
+            else if (arg == "--timeout" || arg == "--global-timeout")
+            {
+                if (idx + 1 >= argc ||
+                    !parse_decimal(argv[idx + 1], arg == "--timeout" ? g_options.timeout : g_options.globalTimeout))
+                {
+                    std::cout << "ERROR:\t'" << arg << "' expects a number of seconds.\n";
+                    return false;
+                }
+                idx++;
+            }
+            else if (arg == "--shard-index")
+            {
+                if (idx + 1 >= argc || !parse_number(argv[idx + 1], g_options.shardIndex))
+                {
+                    std::cout << "ERROR:\t'--shard-index' expects the number of a shard (counting from 0).\n";
+                    return false;
+                }
+                idx++;
+            }
+            else if (arg == "--shard-timings")
+            {
+                if (idx + 1 >= argc)
+                {
+                    std::cout << "ERROR:\t'--shard-timings' expects the name of a history file.\n";
+                    return false;
+                }
+                g_options.shardTimingsFile = argv[++idx];
+            }
+            else if (arg == "--filter" || arg == "--group")
+            {
+                if (idx + 1 >= argc)
+                {
+                    std::cout << "ERROR:\t'" << arg << "' expects a (comma separated) list of patterns.\n";
+                    return false;
+                }
+                add_filters(argv[++idx], arg == "--filter" ? g_options.nameFilters : g_options.groupFilters);
+            }
+            else if (arg.starts_with("--filter=") || arg.starts_with("--group="))
+            {
+                const size_t equals{arg.find('=')};
+                add_filters(arg.substr(equals + 1),
+                            arg.starts_with("--filter=") ? g_options.nameFilters : g_options.groupFilters);
+            }
+            else if (arg == "--list")
+            {
+                g_options.list = true;
+            }
+            else if (arg == "--junit" || arg == "--json")
+            {
+                if (idx + 1 >= argc)
+                {
+                    std::cout << "ERROR:\t'" << arg << "' expects the name of a file to write the results to.\n";
+                    return false;
+                }
+                (arg == "--junit" ? g_options.junitFile : g_options.jsonFile) = argv[++idx];
+            }
+            else if (arg == "--history")
+            {
+                if (idx + 1 >= argc)
+                {
+                    std::cout << "ERROR:\t'--history' expects the name of a history file.\n";
+                    return false;
+                }
+                g_options.historyFile = argv[++idx];
+            }
+            else if (arg == "--no-history")
+            {
+                g_options.historyFile.clear();
+            }
+            else if (arg == "--cache" || arg == "--no-cache")
+            {
+                g_options.cache = (arg == "--cache");
+            }
+            else if (arg == "--fail-fast")
+            {
+                g_options.failFast = 1;
+            }
+            else if (arg.starts_with("--fail-fast="))
+            {
+                if (!parse_number(arg.substr(arg.find('=') + 1), g_options.failFast) || g_options.failFast == 0)
+                {
+                    std::cout << "ERROR:\t'--fail-fast=N' expects a (positive) number of failures.\n";
+                    return false;
+                }
+            }
+            else if (arg == "--failed-first")
+            {
+                g_options.failedFirst = true;
+            }
+            else if (arg == "--repeat" || arg == "--stress")
+            {
+                size_t &value{arg == "--repeat" ? g_options.repeat : g_options.stress};
+                if (idx + 1 >= argc || !parse_number(argv[idx + 1], value) || value == 0)
+                {
+                    std::cout << "ERROR:\t'" << arg << "' expects a (positive) number of "
+                              << (arg == "--repeat" ? "repetitions.\n" : "threads.\n");
+                    return false;
+                }
+                g_options.repeatGiven = g_options.repeatGiven || arg == "--repeat";
+                idx++;
+            }
+            else if (arg == "--repeat-until-fail")
+            {
+                g_options.repeatUntilFail = true;
+            }
+            else if (arg == "--shuffle")
+            {
+                g_options.shuffle = true;
+            }
+            else if (arg == "--seed")
+            {
+                if (idx + 1 >= argc || !parse_number(argv[idx + 1], g_options.seed))
+                {
+                    std::cout << "ERROR:\t'--seed' expects the (numeric) seed to shuffle the tests with.\n";
+                    return false;
+                }
+                g_options.shuffle   = true;
+                g_options.seedGiven = true;
+                idx++;
+            }
+            else if (arg == "--property-cases" || arg == "--property-seed")
+            {
+                size_t &value{arg == "--property-cases" ? g_options.propertyCases : g_options.propertySeed};
+                if (idx + 1 >= argc || !parse_number(argv[idx + 1], value) ||
+                    (arg == "--property-cases" && value == 0))
+                {
+                    std::cout << "ERROR:\t'" << arg << "' expects "
+                              << (arg == "--property-cases" ? "a (positive) number of inputs.\n"
+                                                            : "the (numeric) seed of the inputs.\n");
+                    return false;
+                }
+                idx++;
+            }
+            else if (arg == "--resource-limits")
+            {
+                if (idx + 1 >= argc)
+                {
+                    std::cout << "ERROR:\t'--resource-limits' expects a (comma separated) list of 'name=N' limits.\n";
+                    return false;
+                }
+                g_options.resourceLimits = argv[++idx];
+            }
+            else if (arg == "--total-shards")
+            {
+                if (idx + 1 >= argc || !parse_number(argv[idx + 1], g_options.totalShards))
+                {
+                    std::cout << "ERROR:\t'--total-shards' expects a number of shards.\n";
+                    return false;
+                }
+                idx++;
+            }
+            else
+            {
+                std::cout << "ERROR:\tUnknown argument '" << arg << "'.\n";
+                return false;
+            }
+        }
+
+        if (g_options.totalShards == 0 || g_options.shardIndex >= g_options.totalShards)
+        {
+            std::cout << "ERROR:\tThe shard index (" << g_options.shardIndex
+                      << ") must be less than the total number of shards (" << g_options.totalShards << ").\n";
+            return false;
+        }
+
+        // pick a seed to shuffle with (and print it, so the order can be repeated) if none was given
+        if (g_options.shuffle && !g_options.seedGiven)
+        {
+            std::random_device device;
+            g_options.seed = static_cast<size_t>(
+                (static_cast<uint64_t>(device()) << 32 | device()) ^
+                static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+        }
+        return true;
+    }
+
+    /// @brief reads a history file
+    /// @param path the name of the history file
+    /// @param history the history to add the entries of the file to
+    /// @return true if the file could be read, false otherwise
+    /// @remark each line is "<wall ns>\t<status>\t<fingerprint>\t<name>\t<group>" (the fingerprint is 16 hex digits,
+    /// and the name is an identifier, so it can't contain a tab); lines without a fingerprint (from older versions) are
+    /// read too. Later lines replace earlier ones, so the histories of several shards can be merged by concatenating
+    /// them
+    bool read_history(const std::string &path, History &history)
+    {
+        std::ifstream file{path};
+        if (!file)
+        {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            const size_t statusStart{line.find('\t') + 1};
+            size_t       nameStart{statusStart == 0 ? std::string::npos : line.find('\t', statusStart) + 1};
+            size_t       groupStart{nameStart == 0 || nameStart == std::string::npos ? std::string::npos
+                                                                                      : line.find('\t', nameStart) + 1};
+            if (groupStart == 0 || groupStart == std::string::npos)
+            {
+                continue;
+            }
+
+            const std::string_view view{line};
+            HistoryEntry           entry;
+            size_t                 status{0};
+            if (!parse_number(view.substr(0, statusStart - 1), entry.wallNs) ||
+                !parse_number(view.substr(statusStart, nameStart - statusStart - 1), status) ||
+                status > static_cast<size_t>(TestStatus::timed_out))
+            {
+                continue;
+            }
+            entry.status = static_cast<TestStatus>(status);
+
+            // a (16 hex digit) fingerprint followed by another field comes before the name
+            const size_t nextTab{line.find('\t', groupStart)};
+            const char  *fingerprintEnd{line.data() + groupStart - 1};
+            if (groupStart - nameStart == 17 && nextTab != std::string::npos &&
+                std::from_chars(line.data() + nameStart, fingerprintEnd, entry.fingerprint, 16).ptr == fingerprintEnd)
+            {
+                nameStart  = groupStart;
+                groupStart = nextTab + 1;
+            }
+            else
+            {
+                entry.fingerprint = 0;
+            }
+
+            const std::string_view name{view.substr(nameStart, groupStart - nameStart - 1)};
+            history[get_history_key(view.substr(groupStart), name)] = entry;
+        }
+        return true;
+    }
+
+    /// @brief reads a baseline file (lines of "samples<TAB>name<TAB>group", the samples separated by spaces)
+    /// @param path the path of the baseline file
+    /// @param baseline the baseline to add the benchmarks to (later lines win)
+    /// @return true if the file could be read
+    bool read_baseline(const std::string &path, Baseline &baseline)
+    {
+        std::ifstream file{path};
+        if (!file)
+        {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            const size_t nameStart{line.find('\t') + 1};
+            const size_t groupStart{nameStart == 0 ? std::string::npos : line.find('\t', nameStart) + 1};
+            if (groupStart == 0 || groupStart == std::string::npos)
+            {
+                continue;
+            }
+
+            std::vector<double> samples;
+            const char         *sample{line.c_str()};
+            const char *const   samplesEnd{line.c_str() + nameStart - 1};
+            while (sample < samplesEnd)
+            {
+                char        *parsedEnd{nullptr};
+                const double value{std::strtod(sample, &parsedEnd)};
+                if (parsedEnd == sample || parsedEnd > samplesEnd)
+                {
+                    break;
+                }
+                samples.push_back(value);
+                sample = parsedEnd;
+            }
+
+            const std::string_view view{line};
+            const std::string_view name{view.substr(nameStart, groupStart - nameStart - 1)};
+            baseline[get_history_key(view.substr(groupStart), name)] = std::move(samples);
+        }
+        return true;
+    }
+
+    /// @brief saves the samples of the benchmarks which were measured to the "--save-baseline" file (if given)
+    ///
+    /// any benchmarks which are already in the file, but weren't measured in this run, are kept-- so the baselines of
+    /// several shards can be saved to the same file
+    void write_baseline()
+    {
+        if (g_options.saveBaselineFile.empty())
+        {
+            return;
+        }
+
+        Baseline baseline;
+        read_baseline(g_options.saveBaselineFile, baseline);
+        for (size_t idx{0}; idx < g_benchmarkSamples.size(); idx++)
+        {
+            if (!g_benchmarkSamples[idx].empty())
+            {
+                baseline[get_history_key(get_benchmark_cases()[idx])] = g_benchmarkSamples[idx];
+            }
+        }
+
+        std::ofstream file{g_options.saveBaselineFile, std::ios::trunc};
+        for (const auto &[key, samples] : baseline)
+        {
+            std::string line;
+            for (const double sample : samples)
+            {
+                char buffer[32]{};
+                std::snprintf(buffer, sizeof(buffer), "%.9g", sample);
+                line.append(line.empty() ? "" : " ").append(buffer);
+            }
+            const size_t separator{key.find('\0')};
+            file << line << '\t' << key.substr(separator + 1) << '\t' << key.substr(0, separator) << '\n';
+        }
+        if (!file)
+        {
+            std::cout << "ERROR:\tCould not write the baseline to '" << g_options.saveBaselineFile << "'.\n";
+        }
+    }
+
+    /// @brief reads the history file, the shard timings, and the benchmark baseline (if they were asked for)
+    void read_histories()
+    {
+        const PhaseTimer timer{RunnerPhase::log};
+        if (!g_options.historyFile.empty())
+        {
+            read_history(g_options.historyFile, g_history);
+        }
+        if (!g_options.shardTimingsFile.empty() && !read_history(g_options.shardTimingsFile, g_shardTimings))
+        {
+            std::cout << "INFO:\tCould not read the shard timings from '" << g_options.shardTimingsFile
+                      << "'; sharding by hash instead.\n";
+            g_options.shardTimingsFile.clear();
+        }
+        if (!g_options.baselineFile.empty() && !read_baseline(g_options.baselineFile, g_baseline))
+        {
+            std::cout << "INFO:\tCould not read the baseline from '" << g_options.baselineFile
+                      << "'; the benchmarks won't be compared.\n";
+        }
+    }
+
+    /// @brief adds the results of this run to the history, and writes it back to the history file
+    void write_history()
+    {
+        if (g_options.historyFile.empty())
+        {
+            return;
+        }
+
+        const PhaseTimer timer{RunnerPhase::log};
+
+        for (size_t idx{0}; idx < g_timings.size(); idx++)
+        {
+            if (!g_timings[idx].ran)
+            {
+                continue;
+            }
+            g_history[get_history_key(get_test_cases()[idx])] = HistoryEntry{
+                g_timings[idx].status, static_cast<size_t>(g_timings[idx].wallNs), get_test_cases()[idx].fingerprint};
+        }
+
+        // the tests skipped by the cache keep their entries, so they stay cached until they're rebuilt
+        std::ofstream file{g_options.historyFile, std::ios::trunc};
+        for (const auto &[key, entry] : g_history)
+        {
+            char fingerprint[17]{};
+            std::snprintf(fingerprint, sizeof(fingerprint), "%016llx",
+                          static_cast<unsigned long long>(entry.fingerprint));
+            const size_t separator{key.find('\0')};
+            file << entry.wallNs << '\t' << static_cast<int>(entry.status) << '\t' << fingerprint << '\t'
+                 << key.substr(separator + 1) << '\t' << key.substr(0, separator) << '\n';
+        }
+    }
+
+    /// @brief gets the order to start the tests in when running them on more than one worker
+    /// @return the indices of the tests (in get_test_cases()), slowest first according to the history (if there is
+    /// one), so a long test doesn't start last and hold up the end of the run. With "--failed-first", the tests which
+    /// failed last time start before the others
+    std::vector<size_t> get_start_order()
+    {
+        const PhaseTimer    timer{RunnerPhase::scheduling};
+        std::vector<size_t> order{order_slowest_first(
+            g_history.empty() ? std::vector<double>(get_test_cases().size(), 1.0)
+                              : estimate_durations(get_test_cases(), g_history))};
+        if (g_options.failedFirst)
+        {
+            std::stable_partition(order.begin(), order.end(),
+                                  [](size_t idx) { return failed_last_time(get_test_cases()[idx]); });
+        }
+        return order;
+    }
+
+    /// @brief creates the machine readable reporters which were asked for on the command line
+    /// @return true if every reporter's file could be opened, false otherwise
+    bool create_reporters()
+    {
+        if (!g_options.junitFile.empty())
+        {
+            auto reporter{std::make_unique<JUnitReporter>(g_options.junitFile)};
+            if (!reporter->is_open())
+            {
+                std::cout << "ERROR:\tCould not open '" << g_options.junitFile << "' to write the JUnit results to.\n";
+                return false;
+            }
+            g_reporters.push_back(std::move(reporter));
+        }
+        if (!g_options.jsonFile.empty())
+        {
+            auto reporter{std::make_unique<JsonReporter>(g_options.jsonFile)};
+            if (!reporter->is_open())
+            {
+                std::cout << "ERROR:\tCould not open '" << g_options.jsonFile << "' to write the JSON results to.\n";
+                return false;
+            }
+            g_reporters.push_back(std::move(reporter));
+        }
+        return true;
+    }
+
+    /// @brief checks whether the tests will run in worker processes
+    /// @return true if process isolation was requested and is supported on this platform
+    bool is_isolated()
+    {
+#    ifdef _WIN32
+        return false;
+#    else
+        return g_options.isolate;
+#    endif // _WIN32
+    }
+
+    /// @brief gets the number of worker threads (or worker processes, when isolated) to run the tests on
+    /// @return the number of workers (at least 1, at most the number of tests)
+    size_t get_number_of_jobs()
+    {
+        // spread isolated runs across every core unless told otherwise
+        size_t jobs{(is_isolated() && !g_options.jobsGiven) ? 0 : g_options.jobs};
+        if (jobs == 0)
+        {
+            jobs = std::thread::hardware_concurrency();
+        }
+        jobs = std::min(jobs, get_number_of_tests());
+        return (jobs == 0 ? 1 : jobs);
+    }
+
+    /// @brief formats a rate for printing, with a k/M/G suffix
+    /// @param perSecond the rate (per second)
+    /// @return the formatted rate (e.g. "81.30M")
+    std::string format_rate(double perSecond)
+    {
+        const char *suffix{""};
+        if (perSecond >= 1e9)
+        {
+            perSecond /= 1e9;
+            suffix = "G";
+        }
+        else if (perSecond >= 1e6)
+        {
+            perSecond /= 1e6;
+            suffix = "M";
+        }
+        else if (perSecond >= 1e3)
+        {
+            perSecond /= 1e3;
+            suffix = "k";
+        }
+
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f%s", perSecond, suffix);
+        return buffer;
+    }
+
+    /// @brief reads the time stamp counter (if the platform has one)
+    /// @return the number of ticks (0 if there's no time stamp counter)
+    unsigned long long read_tsc()
+    {
+#    if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#    else
+        return 0;
+#    endif // __x86_64__ || __i386__ || _M_X64 || _M_IX86
+    }
+
+    /// @brief the hardware event counters of a thread, opened the first time they're read
+    ///
+    /// on Linux the counters are a perf_event_open group (cycles, instructions, cache misses, and branch misses) which
+    /// counts the user space work of the thread. The counters run continuously, so a measurement is the difference
+    /// between two reads. If perf_event_open isn't available (or isn't allowed), only the time stamp counter is read
+    class ThreadCounters
+    {
+      public:
+        ThreadCounters() = default;
+        ~ThreadCounters() { close(); }
+        ThreadCounters(const ThreadCounters &)            = delete;
+        ThreadCounters &operator=(const ThreadCounters &) = delete;
+
+        /// @brief opens the counters for the calling thread (unless they're already open)
+        /// @return which of the events are counted (see CounterValues)
+        unsigned open()
+        {
+            if (m_opened)
+            {
+                return m_events;
+            }
+            m_opened = true;
+
+#    ifdef __linux__
+            // the cycles lead the group, so the events are all scheduled (and read) together
+            constexpr std::array<std::pair<uint64_t, unsigned>, 4> events{{
+                {PERF_COUNT_HW_CPU_CYCLES, CounterValues::cyclesEvent},
+                {PERF_COUNT_HW_INSTRUCTIONS, CounterValues::instructionsEvent},
+                {PERF_COUNT_HW_CACHE_MISSES, CounterValues::cacheMissesEvent},
+                {PERF_COUNT_HW_BRANCH_MISSES, CounterValues::branchMissesEvent},
+            }};
+            for (const auto &[config, event] : events)
+            {
+                const int fd{open_event(config, m_count == 0 ? -1 : m_fds[0])};
+                if (fd < 0)
+                {
+                    if (m_count == 0)
+                    {
+                        const int error{errno};
+                        get_unavailable_reason() = std::string{"perf_event_open failed: "} + std::strerror(error);
+                        if (error == EACCES || error == EPERM)
+                        {
+                            get_unavailable_reason().append("; see /proc/sys/kernel/perf_event_paranoid");
+                        }
+                        break;
+                    }
+                    continue;
+                }
+                m_fds[m_count]    = fd;
+                m_order[m_count]  = event;
+                m_events         |= event;
+                m_count++;
+            }
+            if (m_count > 0)
+            {
+                return m_events;
+            }
+#    else
+            get_unavailable_reason() = "hardware counters are only read on Linux";
+#    endif // __linux__
+
+            if (read_tsc() != 0)
+            {
+                m_events = CounterValues::cyclesEvent | CounterValues::tscEvent;
+            }
+            return m_events;
+        }
+
+        /// @brief reads the counters (opening them the first time)
+        /// @return the current (running total) values of the counters
+        CounterValues read()
+        {
+            CounterValues values;
+            values.events = open();
+#    ifdef __linux__
+            if (m_count > 0)
+            {
+                // read_format is PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING
+                struct
+                {
+                    uint64_t count;
+                    uint64_t enabled;
+                    uint64_t running;
+                    uint64_t values[4];
+                } data{};
+                if (::read(m_fds[0], &data, sizeof(data)) <= 0 || data.running == 0)
+                {
+                    return values;
+                }
+
+                // if the group had to share the hardware with other events, scale the counts up to the whole time
+                const double scale{static_cast<double>(data.enabled) / static_cast<double>(data.running)};
+                for (size_t idx{0}; idx < m_count && idx < data.count; idx++)
+                {
+                    const double value{static_cast<double>(data.values[idx]) * scale};
+                    switch (m_order[idx])
+                    {
+                    case CounterValues::cyclesEvent:
+                        values.cycles = value;
+                        break;
+                    case CounterValues::instructionsEvent:
+                        values.instructions = value;
+                        break;
+                    case CounterValues::cacheMissesEvent:
+                        values.cacheMisses = value;
+                        break;
+                    default:
+                        values.branchMisses = value;
+                        break;
+                    }
+                }
+                return values;
+            }
+#    endif // __linux__
+            if ((m_events & CounterValues::tscEvent) != 0)
+            {
+                values.cycles = static_cast<double>(read_tsc());
+            }
+            return values;
+        }
+
+        /// @brief closes the counters (they're opened again the next time they're read)
+        /// @note also used by worker processes, whose copies of the counters belong to the parent's thread
+        void close()
+        {
+#    ifdef __linux__
+            for (size_t idx{0}; idx < m_count; idx++)
+            {
+                ::close(m_fds[idx]);
+            }
+            m_count = 0;
+#    endif // __linux__
+            m_opened = false;
+            m_events = 0;
+        }
+
+        /// @brief gets why the hardware counters couldn't be opened (if they couldn't)
+        /// @return a reference to the reason (empty if they could be, or haven't been tried)
+        static std::string &get_unavailable_reason()
+        {
+            static std::string s_reason;
+            return s_reason;
+        }
+
+      private:
+#    ifdef __linux__
+        /// @brief opens a counter for a hardware event on the calling thread
+        /// @param config which event to count
+        /// @param groupFd the leader of the group to open the counter in (-1 to open a new group)
+        /// @return the file descriptor of the counter (negative if it couldn't be opened)
+        static int open_event(uint64_t config, int groupFd)
+        {
+            perf_event_attr attributes{};
+            attributes.size           = sizeof(attributes);
+            attributes.type           = PERF_TYPE_HARDWARE;
+            attributes.config         = config;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv     = 1;
+            attributes.read_format =
+                PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+        }
+
+        std::array<int, 4>      m_fds{-1, -1, -1, -1}; ///< the counters (the first one leads the group)
+        std::array<unsigned, 4> m_order{};             ///< which event each counter counts
+        size_t                  m_count{0};            ///< how many counters are open
+#    endif                                             // __linux__
+        bool     m_opened{false}; ///< whether the counters have been opened (even if that failed)
+        unsigned m_events{0};     ///< which events are counted
+    };
+
+    /// @brief gets the hardware event counters of the calling thread
+    /// @return a reference to the (thread local) counters
+    ThreadCounters &thread_counters()
+    {
+        thread_local ThreadCounters t_counters;
+        return t_counters;
+    }
+
+    /// @brief reads the hardware event counters of the calling thread, if "--counters" was given
+    /// @return the current (running total) values of the counters (none, if counters weren't asked for)
+    CounterValues read_counters()
+    {
+        if (!g_options.counters)
+        {
+            return {};
+        }
+        const AllocationPause pause;
+        return thread_counters().read();
+    }
+
+    /// @brief works out the events counted between two reads of the counters
+    /// @param start the first read
+    /// @param end the second read
+    /// @return the difference (of the events both reads counted)
+    CounterValues subtract_counters(const CounterValues &start, const CounterValues &end)
+    {
+        CounterValues difference;
+        difference.events       = start.events & end.events;
+        difference.cycles       = end.cycles - start.cycles;
+        difference.instructions = end.instructions - start.instructions;
+        difference.cacheMisses  = end.cacheMisses - start.cacheMisses;
+        difference.branchMisses = end.branchMisses - start.branchMisses;
+        return difference;
+    }
+
+    /// @brief adds up the events counted by two measurements
+    /// @param total the running total (the events it counts are narrowed to those both counted)
+    /// @param values the measurement to add
+    void add_counters(CounterValues &total, const CounterValues &values)
+    {
+        total.events = (total.cycles == 0.0 && total.events == 0 ? values.events : total.events & values.events);
+        total.cycles += values.cycles;
+        total.instructions += values.instructions;
+        total.cacheMisses += values.cacheMisses;
+        total.branchMisses += values.branchMisses;
+    }
+
+    /// @brief the counters of the benchmark loop running on a thread (see ben::tests::detail::begin_loop_counters())
+    struct LoopCounters
+    {
+        CounterValues start;   ///< the counters when the loop began
+        CounterValues counted; ///< the events counted by the loop (once it has ended)
+    };
+
+    /// @brief gets the counters of the benchmark loop running on the calling thread
+    /// @return a reference to the (thread local) loop counters
+    LoopCounters &loop_counters()
+    {
+        thread_local LoopCounters t_loop{};
+        return t_loop;
+    }
+
+    /// @brief describes counted hardware events, e.g. "1.20M cycles, 2.31 IPC, 12.00 cache misses"
+    /// @param values the counted events
+    /// @param operations what to divide the counts by (the number of iterations, for a benchmark)
+    /// @param unit appended to each count (e.g. "/op")
+    /// @return the description (empty if nothing was counted)
+    std::string describe_counters(const CounterValues &values, double operations, std::string_view unit)
+    {
+        std::string description;
+        const auto  append = [&](unsigned event, double value, std::string_view name) {
+            if ((values.events & event) != 0)
+            {
+                description.append(description.empty() ? "" : ", ").append(format_rate(value / operations));
+                description.append(" ").append(name).append(unit);
+            }
+        };
+        append(CounterValues::cyclesEvent, values.cycles,
+               (values.events & CounterValues::tscEvent) != 0 ? "TSC ticks" : "cycles");
+        constexpr unsigned ipcEvents{CounterValues::cyclesEvent | CounterValues::instructionsEvent};
+        if ((values.events & ipcEvents) == ipcEvents && values.cycles > 0.0)
+        {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), ", %.2f IPC", values.instructions / values.cycles);
+            description.append(buffer);
+        }
+        append(CounterValues::cacheMissesEvent, values.cacheMisses, "cache misses");
+        append(CounterValues::branchMissesEvent, values.branchMisses, "branch misses");
+        return description;
+    }
+
+    /// @brief keeps apart the tests which can't share the machine (see the "exclusive", "threads=N", and "resource=R"
+    /// attributes of bTEST_FUNCTION) when the tests run in parallel
+    ///
+    /// the runners ask the gate for the next test to start rather than taking it straight from their queues. A test
+    /// which can't start yet (an exclusive test is running, there aren't enough free threads for it, or one of its
+    /// resources is at its limit) is put aside, and the tests which were put aside get the first go whenever a test
+    /// finishes. Once one of them is waiting for threads, the tests after it can't take any, so a test which needs a
+    /// lot of the machine isn't starved by the small ones. Nothing is locked unless some test has one of the attributes
+    class ResourceGate
+    {
+      public:
+        /// @brief works out what each test needs
+        /// @param testCases the tests
+        /// @param slots the number of threads the tests share (i.e. the number of workers)
+        void start(const std::vector<TestCase> &testCases, size_t slots)
+        {
+            m_slots = std::max<size_t>(slots, 1);
+            m_needs.assign(testCases.size(), Needs{});
+            for (size_t idx{0}; idx < testCases.size(); idx++)
+            {
+                const TestCase &testCase{testCases[idx]};
+                Needs          &needs{m_needs[idx]};
+                needs.exclusive = testCase.exclusive;
+                needs.firstUse  = m_uses.size();
+
+                // async tests don't hold on to a thread while they wait, so they only take threads if they ask to
+                needs.threads = (testCase.threads > 0 ? testCase.threads : (testCase.asyncTest != nullptr ? 0 : 1));
+
+                std::string_view resources;
+                if (find_attribute(testCase.attributes, "resource", resources))
+                {
+                    while (!resources.empty())
+                    {
+                        const size_t separator{std::min(resources.find('+'), resources.size())};
+                        if (separator > 0)
+                        {
+                            m_uses.push_back(get_resource(resources.substr(0, separator)));
+                        }
+                        resources.remove_prefix(std::min(separator + 1, resources.size()));
+                    }
+                }
+                needs.useCount = m_uses.size() - needs.firstUse;
+
+                m_exclusiveTests += (needs.exclusive ? 1 : 0);
+                m_threadedTests += (testCase.threads > 0 ? 1 : 0);
+                m_resourceTests += (needs.useCount > 0 ? 1 : 0);
+            }
+            m_used.assign(m_resources.size(), 0);
+            m_enabled = (m_exclusiveTests + m_threadedTests + m_resourceTests > 0);
+        }
+
+        /// @brief checks whether any test has attributes the gate has to enforce
+        /// @return true if so (otherwise the runners don't need to ask the gate for anything)
+        bool is_enabled() const
+        {
+            return m_enabled;
+        }
+
+        /// @brief describes what the gate enforces
+        /// @return the description, e.g. "1 test running alone, 3 tests using resources (gpu: 1 at a time)"
+        std::string describe() const
+        {
+            std::string description;
+            const auto  append = [&description](size_t tests, std::string_view what) {
+                if (tests > 0)
+                {
+                    description.append(description.empty() ? "" : ", ").append(std::to_string(tests));
+                    description.append(tests == 1 ? " test " : " tests ").append(what);
+                }
+            };
+            append(m_exclusiveTests, "running alone");
+            append(m_threadedTests, "with a thread count");
+            append(m_resourceTests, "using resources");
+            for (size_t resource{0}; resource < m_resources.size(); resource++)
+            {
+                description.append(resource == 0 ? " (" : ", ").append(m_resources[resource]).append(": ");
+                description.append(std::to_string(m_limits[resource])).append(" at a time");
+            }
+            return description.append(m_resources.empty() ? "" : ")");
+        }
+
+        /// @brief picks the next test to start, and counts what it uses until it's released
+        /// @param pop takes the next test from the runner's queue (returning false once there are none left)
+        /// @param idx set to the test to start
+        /// @param wait whether to wait for a running test to finish when none of the tests which are left can start
+        /// @return true if there's a test to start; false once every test has started (or, if not waiting, when none of
+        /// them can start yet)
+        template <typename Pop>
+        bool next(Pop &&pop, size_t &idx, bool wait)
+        {
+            std::unique_lock lock{m_mutex};
+            while (true)
+            {
+                bool threadsBlocked{false};
+                for (auto waiting{m_waiting.begin()}; waiting != m_waiting.end(); ++waiting)
+                {
+                    const Fit fit{fits(*waiting, threadsBlocked)};
+                    if (fit == Fit::yes)
+                    {
+                        idx = *waiting;
+                        m_waiting.erase(waiting);
+                        count(idx, true);
+                        return true;
+                    }
+                    threadsBlocked = threadsBlocked || fit == Fit::threads;
+                }
+
+                // only take another test from the queue if there's room for it (otherwise it would just wait too)
+                const uint64_t releases{m_releases};
+                const bool     room{!threadsBlocked && m_usedThreads < m_slots};
+                if (room)
+                {
+                    lock.unlock();
+                    const bool popped{pop(idx)};
+                    lock.lock();
+                    if (popped)
+                    {
+                        m_waiting.push_back(idx);
+                        continue;
+                    }
+                    if (m_waiting.empty())
+                    {
+                        return false;
+                    }
+                }
+
+                if (!wait)
+                {
+                    return false;
+                }
+                m_released.wait(lock, [&]() { return m_releases != releases; });
+            }
+        }
+
+        /// @brief releases what a test used, once it has finished
+        /// @param idx the test
+        void release(size_t idx)
+        {
+            if (!m_enabled)
+            {
+                return;
+            }
+            {
+                std::lock_guard lock{m_mutex};
+                count(idx, false);
+                m_releases++;
+            }
+            m_released.notify_all();
+        }
+
+        /// @brief puts a test which was picked (but couldn't be handed to a worker) back at the front of the line
+        /// @param idx the test
+        void put_back(size_t idx)
+        {
+            release(idx);
+            std::lock_guard lock{m_mutex};
+            m_waiting.push_front(idx);
+        }
+
+        /// @brief takes one of the tests which are waiting to start, without starting it (when the run is stopping, or
+        /// there's nothing left to run it on)
+        /// @param idx set to the test
+        /// @return true if a test was waiting
+        bool take_waiting(size_t &idx)
+        {
+            std::lock_guard lock{m_mutex};
+            if (m_waiting.empty())
+            {
+                return false;
+            }
+            idx = m_waiting.front();
+            m_waiting.pop_front();
+            return true;
+        }
+
+      private:
+        /// @brief what a test needs while it runs
+        struct Needs
+        {
+            bool   exclusive{false}; ///< whether it has to run alone
+            size_t threads{1};       ///< how many of the threads it takes
+            size_t firstUse{0};      ///< where its resources start (in m_uses)
+            size_t useCount{0};      ///< how many resources it uses
+        };
+
+        /// @brief whether a test can start now (or what it's waiting for)
+        enum struct Fit
+        {
+            yes,       ///< it can start
+            threads,   ///< it's waiting for threads (or to run alone, or for an exclusive test to finish)
+            resources, ///< it's waiting for one of its resources
+        };
+
+        /// @brief gets the index of a resource, adding it (with its limit from "--resource-limits") if it's new
+        /// @param name the name of the resource
+        /// @return the index
+        size_t get_resource(std::string_view name)
+        {
+            for (size_t resource{0}; resource < m_resources.size(); resource++)
+            {
+                if (m_resources[resource] == name)
+                {
+                    return resource;
+                }
+            }
+
+            size_t           limit{1};
+            std::string_view value;
+            if (find_attribute(g_options.resourceLimits, name, value) && (!parse_number(value, limit) || limit == 0))
+            {
+                std::cout << "ERROR:\tIgnoring the invalid limit '" << value << "' of the resource '" << name
+                          << "'; it's used by one test at a time.\n";
+                limit = 1;
+            }
+            m_resources.emplace_back(name);
+            m_limits.push_back(limit);
+            return m_resources.size() - 1;
+        }
+
+        /// @brief checks whether a test can start now
+        /// @param idx the test
+        /// @param threadsBlocked whether a test ahead of it is waiting for threads
+        /// @return whether it can start (or what it's waiting for)
+        /// @note the mutex must be held
+        Fit fits(size_t idx, bool threadsBlocked) const
+        {
+            // once the run is stopping, the tests which are left are only drained
+            if (g_stopStarting)
+            {
+                return Fit::yes;
+            }
+
+            const Needs &needs{m_needs[idx]};
+            if (m_exclusiveRunning || (needs.exclusive && m_running > 0))
+            {
+                return Fit::threads;
+            }
+            // (a test which wants more threads than there are runs once nothing else is)
+            if (needs.threads > 0 && (threadsBlocked || (m_usedThreads + needs.threads > m_slots && m_running > 0)))
+            {
+                return Fit::threads;
+            }
+            for (size_t use{needs.firstUse}; use < needs.firstUse + needs.useCount; use++)
+            {
+                if (m_used[m_uses[use]] >= m_limits[m_uses[use]])
+                {
+                    return Fit::resources;
+                }
+            }
+            return Fit::yes;
+        }
+
+        /// @brief counts (or stops counting) what a test uses
+        /// @param idx the test
+        /// @param starting true when the test starts, false when it finishes
+        /// @note the mutex must be held
+        void count(size_t idx, bool starting)
+        {
+            const Needs &needs{m_needs[idx]};
+            m_running          = (starting ? m_running + 1 : m_running - 1);
+            m_usedThreads      = (starting ? m_usedThreads + needs.threads : m_usedThreads - needs.threads);
+            m_exclusiveRunning = (needs.exclusive ? starting : m_exclusiveRunning);
+            for (size_t use{needs.firstUse}; use < needs.firstUse + needs.useCount; use++)
+            {
+                size_t &used{m_used[m_uses[use]]};
+                used = (starting ? used + 1 : used - 1);
+            }
+        }
+
+        bool                     m_enabled{false};
+        size_t                   m_slots{1};
+        std::vector<Needs>       m_needs;     // (one per test)
+        std::vector<size_t>      m_uses;      // (the resources each test uses, see Needs::firstUse)
+        std::vector<std::string> m_resources; // (the names of the resources)
+        std::vector<size_t>      m_limits;    // (how many tests may use each resource at once)
+        size_t                   m_exclusiveTests{0};
+        size_t                   m_threadedTests{0};
+        size_t                   m_resourceTests{0};
+
+        std::mutex              m_mutex;
+        std::condition_variable m_released;
+        std::deque<size_t>      m_waiting;  // (the tests which were put aside, in the order they were taken)
+        std::vector<size_t>     m_used;     // (how many running tests use each resource)
+        size_t                  m_running{0};
+        size_t                  m_usedThreads{0};
+        bool                    m_exclusiveRunning{false};
+        uint64_t                m_releases{0};
+    };
+
+    /// @brief the gate which keeps apart the tests which can't share the machine
+    static ResourceGate g_resourceGate{};
+
+    /// @brief prints information regarding the tests which are about to be performed as well as what the return value
+    /// of the program indicates
+    void print_info()
+    {
+        const PhaseTimer timer{RunnerPhase::reporting};
+        print_line_separator();
+        std::cout << "INFO:\tIf all tests pass (or no tests fail), the program will return success."
+                     "\n\t\tOtherwise, it will return failure.\n";
+        if (g_options.totalShards > 1)
+        {
+            std::cout << "INFO:\tRunning shard " << g_options.shardIndex << " (counting from 0) of "
+                      << g_options.totalShards << "; only the tests and benchmarks in this shard are counted.\n";
+        }
+        std::cout << "INFO:\tFound " << get_number_of_tests() << " test" << (get_number_of_tests() == 1 ? "" : "s")
+                  << " in " << get_number_of_groups() << " group" << (get_number_of_groups() == 1 ? ".\n" : "s.\n");
+        if (g_cachedTests > 0)
+        {
+            std::cout << "INFO:\tSkipping " << g_cachedTests << " test" << (g_cachedTests == 1 ? "" : "s")
+                      << " which passed last time and " << (g_cachedTests == 1 ? "hasn't" : "haven't")
+                      << " been rebuilt since; '--no-cache' runs them.\n";
+        }
+        if (get_number_of_benchmarks() > 0)
+        {
+            std::cout << "INFO:\tFound " << get_number_of_benchmarks() << " benchmark"
+                      << (get_number_of_benchmarks() == 1 ? "" : "s")
+                      << "; benchmarks run (serially) after the tests.\n";
+        }
+        if (g_options.isolate && !is_isolated())
+        {
+            std::cout << "INFO:\tProcess isolation is not supported on this platform; running tests in-process.\n";
+        }
+        if (is_isolated())
+        {
+            std::cout << "INFO:\tRunning tests in " << get_number_of_jobs() << " worker process"
+                      << (get_number_of_jobs() == 1 ? ".\n" : "es.\n");
+        }
+        else if (get_number_of_jobs() > 1)
+        {
+            std::cout << "INFO:\tRunning tests on " << get_number_of_jobs() << " worker threads.\n";
+        }
+        const bool parallel{is_isolated() || get_number_of_jobs() > 1 || get_number_of_async_tests() > 0};
+        if (g_resourceGate.is_enabled() && parallel)
+        {
+            std::cout << "INFO:\tScheduling around the tests' attributes: " << g_resourceGate.describe() << ".\n";
+        }
+        if (get_number_of_async_tests() > 0 && !is_isolated())
+        {
+            std::cout << "INFO:\tDriving " << get_number_of_async_tests() << " async test"
+                      << (get_number_of_async_tests() == 1 ? "" : "s") << " on an event loop of "
+                      << std::max(bTESTS_ASYNC_THREADS, 1) << " thread" << (bTESTS_ASYNC_THREADS == 1 ? "" : "s")
+                      << (is_repeating() ? " (one run at a time, since each test runs more than once).\n"
+                                         : "; they're in flight at the same time as the other tests.\n");
+        }
+        if (g_options.shuffle)
+        {
+            std::cout << "INFO:\tShuffling the tests with seed " << g_options.seed << "; '--seed " << g_options.seed
+                      << "' runs them in the same order again.\n";
+        }
+        if (is_repeating())
+        {
+            std::cout << "INFO:\tRunning each test ";
+            if (g_options.repeatUntilFail)
+            {
+                std::cout << "until it fails"
+                          << (g_options.repeatGiven ? " (at most " + std::to_string(g_options.repeat) + " times)" : "");
+            }
+            else
+            {
+                std::cout << g_options.repeat << (g_options.repeat == 1 ? " time" : " times");
+            }
+            if (g_options.stress > 1)
+            {
+                std::cout << ", on " << g_options.stress << " threads at once";
+            }
+            std::cout << "; the runs are reported together.\n";
+        }
+        if (g_options.profileRunner && is_isolated())
+        {
+            std::cout << "INFO:\tThe tests run in worker processes, so '--profile-runner' can't time the tests (or the "
+                         "capture around them).\n";
+        }
+        if (!g_baseline.empty() && g_options.benchmarks && get_number_of_benchmarks() > 0)
+        {
+            char threshold[32]{};
+            std::snprintf(threshold, sizeof(threshold), "%.2f%%", g_options.regressionThreshold);
+            std::cout << "INFO:\tComparing the benchmarks with the baseline '" << g_options.baselineFile
+                      << "'; a significant slowdown of more than " << threshold << " fails the run.\n";
+        }
+        if (!g_options.trendFile.empty())
+        {
+            std::cout << "INFO:\tAppending this run to the trend file '" << g_options.trendFile << "' (tagged '"
+                      << g_options.trendTag << "').\n";
+        }
+        if (g_options.counters)
+        {
+            // open this thread's counters now, to find out what can be counted
+            const unsigned events{thread_counters().open()};
+            if ((events & CounterValues::tscEvent) != 0)
+            {
+                std::cout << "INFO:\tHardware counters aren't available (" << ThreadCounters::get_unavailable_reason()
+                          << "); counting time stamp counter ticks instead.\n";
+            }
+            else if (events == 0)
+            {
+                std::cout << "INFO:\tHardware counters aren't available (" << ThreadCounters::get_unavailable_reason()
+                          << "); '--counters' is ignored.\n";
+            }
+            else
+            {
+                std::string counted;
+                const auto  append = [&](unsigned event, std::string_view name) {
+                    if ((events & event) != 0)
+                    {
+                        counted.append(counted.empty() ? "" : ", ").append(name);
+                    }
+                };
+                append(CounterValues::cyclesEvent, "cycles");
+                append(CounterValues::instructionsEvent, "instructions");
+                append(CounterValues::cacheMissesEvent, "cache misses");
+                append(CounterValues::branchMissesEvent, "branch misses");
+                std::cout << "INFO:\tCounting hardware events (" << counted << ") with perf_event_open.\n";
+            }
+        }
+        print_line_separator();
+    }
+
+    /// @brief lists the selected tests (and benchmarks) in this shard, one per line under the name of their group
+    void print_list()
+    {
+        std::string list;
+        const auto  append = [&list](const std::vector<TestCase> &testCases, std::string_view suffix) {
+            for (size_t idx{0}; idx < testCases.size(); idx++)
+            {
+                if (idx == 0 || testCases[idx - 1].group != testCases[idx].group)
+                {
+                    list.append(testCases[idx].group).append(":\n");
+                }
+                list.append("\t").append(testCases[idx].name).append(suffix).append("\n");
+            }
+        };
+        append(get_test_cases(), "");
+        if (g_options.benchmarks)
+        {
+            append(get_benchmark_cases(), " (benchmark)");
+        }
+        std::cout.write(list.data(), static_cast<std::streamsize>(list.size()));
+    }
+
+    /// @brief gets the CPU time used so far by the calling thread
+    /// @return the CPU time (in nanoseconds)
+    double get_thread_cpu_ns()
+    {
+#    ifdef _WIN32
+        FILETIME creation{}, exit{}, kernel{}, user{};
+        if (GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user) == 0)
+        {
+            return 0.0;
+        }
+        const auto toTicks = [](const FILETIME &time) {
+            return (static_cast<unsigned long long>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+        // FILETIMEs count in 100 ns ticks
+        return static_cast<double>(toTicks(kernel) + toTicks(user)) * 100.0;
+#    else
+        timespec time{};
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+        {
+            return 0.0;
+        }
+        return static_cast<double>(time.tv_sec) * 1e9 + static_cast<double>(time.tv_nsec);
+#    endif // _WIN32
+    }
+
+    /// @brief gets the result of the test which is running on the calling thread
+    /// @return a reference to the (thread local) pointer to the result (nullptr if no test is running)
+    TestResult *&current_result()
+    {
+        thread_local TestResult *t_result{nullptr};
+        return t_result;
+    }
+
+    /// @brief gets the group of the test which is running on the calling thread (which group fixtures belong to)
+    /// @return a reference to the (thread local) group (empty if no test is running)
+    std::string_view &current_group()
+    {
+        thread_local std::string_view t_group{};
+        return t_group;
+    }
+
+    /// @brief identifies a fixture: its type, and the scope (and group and thread, if needed) it's shared within
+    struct FixtureKey
+    {
+        ben::tests::detail::FixtureScope scope{ben::tests::detail::FixtureScope::suite};
+        std::string                      group{};
+        std::thread::id                  thread{};
+        const void                      *type{nullptr};
+
+        bool operator<(const FixtureKey &other) const
+        {
+            return std::tie(scope, group, thread, type) < std::tie(other.scope, other.group, other.thread, other.type);
+        }
+    };
+
+    /// @brief a (lazily constructed) fixture
+    struct Fixture
+    {
+        std::once_flag created{};
+        void          *object{nullptr};
+        void (*destroy)(void *){nullptr};
+        size_t order{0}; ///< when the fixture was created (fixtures are destroyed in reverse order)
+
+        ~Fixture()
+        {
+            if (object != nullptr)
+            {
+                destroy(object);
+            }
+        }
+    };
+
+    /// @brief guards the fixtures (but not their construction, which happens outside of the lock)
+    static std::mutex g_fixturesMutex;
+
+    /// @brief every fixture which has been asked for (and not yet torn down)
+    static std::map<FixtureKey, std::shared_ptr<Fixture>> g_fixtures;
+
+    /// @brief counts the fixtures as they're created (to destroy them in reverse order)
+    static std::atomic<size_t> g_fixturesCreated{0};
+
+    /// @brief destroys fixtures, most recently created first
+    /// @param group the group whose (group and thread) fixtures should be destroyed; if nullptr, every fixture
+    /// (including the suite fixtures) is destroyed
+    /// @note must only be called once nothing is using the fixtures (i.e. every test in the group has finished);
+    /// anything the fixtures print while they're destroyed is discarded
+    void tear_down_fixtures(const std::string_view *group)
+    {
+        // move the fixtures out of the map, so they're destroyed without holding the lock
+        std::vector<std::shared_ptr<Fixture>> fixtures;
+        {
+            std::lock_guard lock{g_fixturesMutex};
+            for (auto fixture{g_fixtures.begin()}; fixture != g_fixtures.end();)
+            {
+                const FixtureKey &key{fixture->first};
+                if (group == nullptr || (key.scope != ben::tests::detail::FixtureScope::suite && key.group == *group))
+                {
+                    fixtures.push_back(std::move(fixture->second));
+                    fixture = g_fixtures.erase(fixture);
+                }
+                else
+                {
+                    ++fixture;
+                }
+            }
+        }
+
+        std::sort(fixtures.begin(), fixtures.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs->order > rhs->order;
+        });
+
+        std::streambuf *const previousTarget{ThreadRoutingBuffer::target()};
+        ThreadRoutingBuffer::target() = nullptr;
+        fixtures.clear();
+        ThreadRoutingBuffer::target() = previousTarget;
+    }
+
+    /// @brief records a failure in a result; the first failure is the one the result reports
+    /// @param result the result of the test which failed
+    /// @param failure where (or how) the test failed
+    /// @param expression the text of the expression which was false (if any)
+    void record_failure_in(TestResult &result, std::string_view failure, std::string_view expression)
+    {
+        const AllocationPause pause;
+        if (result.failures++ == 0)
+        {
+            result.failure.assign(failure);
+            result.expression.assign(expression);
+        }
+    }
+
+#    ifndef bTESTS_NO_EXCEPTIONS
+    /// @brief records the exception which is being handled (i.e. a failed assertion) as a failure in a result
+    /// @param result the result of the test which threw
+    /// @note must be called from within a catch block
+    void record_current_exception(TestResult &result)
+    {
+        try
+        {
+            throw;
+        }
+        catch (const ben::tests::AssertionFailure &e)
+        {
+            record_failure_in(result, std::string{e.file()} + ":" + std::to_string(e.line()), e.expression());
+        }
+        catch (const std::exception &e)
+        {
+            record_failure_in(result, e.what(), {});
+        }
+        catch (...)
+        {
+            record_failure_in(result, "unknown exception", {});
+        }
+    }
+#    endif // !bTESTS_NO_EXCEPTIONS
+
+    /// @brief runs a function (a test, or a whole benchmark), capturing its output into the result
+    /// @param result the result of the function; passed unless the function throws or records a failure
+    /// @param func the function to run
+    template <typename Fn>
+    void run_captured(TestResult &result, Fn &&func)
+    {
+        const PhaseTimer timer{RunnerPhase::capture};
+
+        // std::cout (from this thread) goes straight into the result's log, which is written to the log file in one
+        // piece once the test is reported. The previous target is restored afterwards, since tests run serially on the
+        // same thread which prints to the console
+        std::streambuf *const previousTarget{ThreadRoutingBuffer::target()};
+#    ifndef bTESTS_NO_LOG
+        CaptureBuffer capture{result.log};
+        ThreadRoutingBuffer::target() = &capture;
+#    else
+        ThreadRoutingBuffer::target() = nullptr;
+#    endif // !bTESTS_NO_LOG
+
+        // failed expectations are recorded in the result of the test running on this thread
+        TestResult *const previousResult{current_result()};
+        current_result() = &result;
+
+        // count the allocations the function makes; the peak is measured from the bytes which are live right now
+        AllocationCounters &allocations{thread_allocations()};
+        const long long     peakBefore{allocations.peakBytes};
+        allocations.peakBytes = allocations.liveBytes;
+        const AllocationCounters allocationsStart{allocations};
+
+        // time the function with a monotonic clock (wall time) and the thread's CPU clock
+        const std::chrono::steady_clock::time_point wallStart{std::chrono::steady_clock::now()};
+        const double                                cpuStart{get_thread_cpu_ns()};
+        const CounterValues                         countersStart{read_counters()};
+
+#    ifndef bTESTS_NO_EXCEPTIONS
+        // use exceptions to figure out if tests fail (on top of any failed expectations)
+        try
+        {
+            const PhaseTimer body{RunnerPhase::tests};
+            func();
+        }
+
+        // catch the exceptions (i.e. a failed assertion)
+        catch (...)
+        {
+            record_current_exception(result);
+        }
+#    else
+        {
+            const PhaseTimer body{RunnerPhase::tests};
+            func();
+        }
+#    endif // !bTESTS_NO_EXCEPTIONS
+
+        result.counters = subtract_counters(countersStart, read_counters());
+        result.cpuNs    = get_thread_cpu_ns() - cpuStart;
+        result.wallNs = std::chrono::duration<double, std::nano>{std::chrono::steady_clock::now() - wallStart}.count();
+        result.status = (result.failures == 0 ? TestStatus::passed : TestStatus::failed);
+
+        result.allocations    = allocations.allocations - allocationsStart.allocations;
+        result.allocatedBytes = allocations.bytes - allocationsStart.bytes;
+        result.peakBytes      = static_cast<size_t>(std::max(0LL, allocations.peakBytes - allocationsStart.liveBytes));
+        result.leakedBytes    = static_cast<size_t>(std::max(0LL, allocations.liveBytes - allocationsStart.liveBytes));
+        allocations.peakBytes = std::max(peakBefore, allocations.peakBytes);
+
+        current_result()              = previousResult;
+        ThreadRoutingBuffer::target() = previousTarget;
+    }
+
+    /// @brief formats a duration for printing, picking a sensible unit
+    /// @param nanoseconds the duration (in nanoseconds)
+    /// @return the formatted duration (e.g. "12.34 us")
+    std::string format_nanoseconds(double nanoseconds)
+    {
+        const char *unit{"ns"};
+        if (nanoseconds >= 1e9)
+        {
+            nanoseconds /= 1e9;
+            unit = "s";
+        }
+        else if (nanoseconds >= 1e6)
+        {
+            nanoseconds /= 1e6;
+            unit = "ms";
+        }
+        else if (nanoseconds >= 1e3)
+        {
+            nanoseconds /= 1e3;
+            unit = "us";
+        }
+
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f %s", nanoseconds, unit);
+        return buffer;
+    }
+
+    /// @brief gets the timeout of a test
+    /// @param testCase the test
+    /// @return the number of seconds the test may run for (0 means no limit)
+    double get_timeout(const TestCase &testCase)
+    {
+        return (testCase.timeout > 0.0 ? testCase.timeout : g_options.timeout);
+    }
+
+    /// @brief an async test which is in flight on the event loop
+    struct AsyncTest
+    {
+        uint64_t                             id{0};             ///< identifies the test on the loop (never reused)
+        const TestCase                      *testCase{nullptr}; ///< the test
+        TestResult                          *result{nullptr};   ///< the result of the test (final once it finishes)
+        ben::tests::Task<>                   task;              ///< the coroutine of the test
+        std::function<void()>                onFinished;        ///< called (on a loop thread) once the result is final
+        int64_t                              started{0};        ///< when the test was started (see get_now_ns())
+        bool                                 resuming{false};   ///< whether a loop thread is running the coroutine
+        std::vector<std::coroutine_handle<>> pending;           ///< resumes posted while the coroutine was running
+    };
+
+    /// @brief drives the async (coroutine) tests on a few threads (bTESTS_ASYNC_THREADS), so that many of them can be
+    /// waiting (e.g. on I/O) at once
+    ///
+    /// whenever something the coroutine of a test awaits posts it (see ben::tests::detail::post_to_loop), it's resumed
+    /// on a free loop thread, with the test's output, result, and group routed to it for as long as it runs. A test's
+    /// coroutine is never resumed on two threads at once: a resume posted while it's running waits until it suspends.
+    /// A test which is still suspended once its timeout passes is reported as timed out, and its coroutine abandoned
+    /// (it can't be destroyed safely while something may still resume it). Everything queued for a test refers to it by
+    /// its id rather than its address, so a deadline (or a late resume) of a test which has finished is dropped instead
+    /// of reaching a later test which happens to reuse the memory. The threads are only started once there's something
+    /// to run, so forked worker processes start their own
+    class EventLoop
+    {
+      public:
+        EventLoop() = default;
+
+        EventLoop(const EventLoop &)            = delete;
+        EventLoop &operator=(const EventLoop &) = delete;
+
+        ~EventLoop()
+        {
+            stop();
+        }
+
+        /// @brief starts an async test, without waiting for it to finish
+        /// @param testCase the test
+        /// @param result the result of the test; it mustn't be touched until onFinished is called
+        /// @param onFinished called (on a loop thread) once the test has passed, failed, or timed out
+        void start(const TestCase &testCase, TestResult &result, std::function<void()> onFinished)
+        {
+            std::unique_ptr<AsyncTest> test{std::make_unique<AsyncTest>(AsyncTest{
+                0, &testCase, &result, testCase.asyncTest(), std::move(onFinished), get_now_ns(), false, {}})};
+            const double timeout{get_timeout(testCase)};
+            {
+                std::lock_guard lock{m_mutex};
+                start_threads();
+                test->id = ++m_lastId;
+                if (timeout > 0.0)
+                {
+                    m_deadlines.push(
+                        Timer{test->started + static_cast<int64_t>(timeout * 1e9), m_sequence++, test->id, {}});
+                }
+                m_ready.push_back(Ready{test->id, test->task.get_handle()});
+                m_tests.emplace(test->id, std::move(test));
+            }
+            m_wake.notify_one();
+        }
+
+        /// @brief resumes a coroutine of an async test on a loop thread
+        /// @param test the id of the test the coroutine belongs to (0 to resume it without any test's context)
+        /// @param handle the coroutine
+        /// @param delayNs how long to wait (in nanoseconds) before resuming it
+        void post(uint64_t test, std::coroutine_handle<> handle, long long delayNs)
+        {
+            {
+                std::lock_guard lock{m_mutex};
+                start_threads();
+                if (delayNs > 0)
+                {
+                    m_timers.push(Timer{get_now_ns() + delayNs, m_sequence++, test, handle});
+                }
+                else
+                {
+                    m_ready.push_back(Ready{test, handle});
+                }
+            }
+            m_wake.notify_one();
+        }
+
+        /// @brief stops the loop threads, once everything they're running has suspended (or finished)
+        void stop()
+        {
+            {
+                std::lock_guard lock{m_mutex};
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            for (std::thread &thread : m_threads)
+            {
+                thread.join();
+            }
+            m_threads.clear();
+            m_stopping = false;
+        }
+
+      private:
+        /// @brief a coroutine which is ready to be resumed
+        struct Ready
+        {
+            uint64_t                test{0}; ///< the id of the test the coroutine belongs to (0 if none)
+            std::coroutine_handle<> handle;  ///< the coroutine
+        };
+
+        /// @brief a coroutine which is sleeping, or the deadline of a test (which has no coroutine)
+        struct Timer
+        {
+            int64_t                 due{0};      ///< when the timer is due (see get_now_ns())
+            uint64_t                sequence{0}; ///< keeps timers which are due at the same time in order
+            uint64_t                test{0};     ///< the id of the test the timer belongs to
+            std::coroutine_handle<> handle;      ///< the coroutine to resume (null for a deadline)
+
+            bool operator>(const Timer &other) const
+            {
+                return std::tie(due, sequence) > std::tie(other.due, other.sequence);
+            }
+        };
+
+        using TimerQueue = std::priority_queue<Timer, std::vector<Timer>, std::greater<>>;
+
+        /// @brief gets the time on a monotonic clock
+        /// @return the time (in nanoseconds since some arbitrary point)
+        static int64_t get_now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        /// @brief starts the loop threads, unless they're running already
+        /// @note the mutex must be held
+        void start_threads()
+        {
+            while (m_threads.size() < static_cast<size_t>(std::max(bTESTS_ASYNC_THREADS, 1)))
+            {
+                m_threads.emplace_back([this]() { work(); });
+            }
+        }
+
+        /// @brief the body of a loop thread
+        void work()
+        {
+            std::unique_lock lock{m_mutex};
+            while (true)
+            {
+                const int64_t now{get_now_ns()};
+                while (!m_timers.empty() && m_timers.top().due <= now)
+                {
+                    m_ready.push_back(Ready{m_timers.top().test, m_timers.top().handle});
+                    m_timers.pop();
+                }
+
+                if (!m_deadlines.empty() && m_deadlines.top().due <= now)
+                {
+                    // (the test may have finished since; its id isn't reused, so a stale deadline finds nothing)
+                    const uint64_t test{m_deadlines.top().test};
+                    m_deadlines.pop();
+                    const auto found{m_tests.find(test)};
+                    if (found == m_tests.end())
+                    {
+                        continue;
+                    }
+
+                    // a test which is running can't be touched; it's timed out once it suspends
+                    if (found->second->resuming)
+                    {
+                        const int64_t retry{now + 1'000'000LL * bTESTS_WATCHDOG_INTERVAL_MS};
+                        m_deadlines.push(Timer{retry, m_sequence++, test, {}});
+                        continue;
+                    }
+
+                    std::unique_ptr<AsyncTest> expired{std::move(found->second)};
+                    m_tests.erase(found);
+                    lock.unlock();
+                    time_out(*expired);
+                    static_cast<void>(expired.release());
+                    lock.lock();
+                    continue;
+                }
+
+                if (!m_ready.empty())
+                {
+                    const Ready ready{m_ready.front()};
+                    m_ready.pop_front();
+                    if (ready.test == 0)
+                    {
+                        lock.unlock();
+                        ready.handle.resume();
+                        lock.lock();
+                        continue;
+                    }
+
+                    // (the test may have finished, or timed out, since the coroutine was posted)
+                    const auto found{m_tests.find(ready.test)};
+                    if (found == m_tests.end())
+                    {
+                        continue;
+                    }
+                    AsyncTest &test{*found->second};
+                    if (test.resuming)
+                    {
+                        test.pending.push_back(ready.handle);
+                        continue;
+                    }
+
+                    test.resuming = true;
+                    lock.unlock();
+                    const bool done{resume(test, ready.handle)};
+                    lock.lock();
+                    test.resuming = false;
+                    for (const std::coroutine_handle<> handle : test.pending)
+                    {
+                        m_ready.push_back(Ready{test.id, handle});
+                    }
+                    test.pending.clear();
+
+                    if (done)
+                    {
+                        std::unique_ptr<AsyncTest> finished{std::move(found->second)};
+                        m_tests.erase(found);
+                        lock.unlock();
+                        finish(*finished);
+                        finished.reset();
+                        lock.lock();
+                    }
+                    continue;
+                }
+
+                if (m_stopping)
+                {
+                    return;
+                }
+
+                // sleep until the next timer (or deadline) is due, or something is posted
+                int64_t next{INT64_MAX};
+                for (const TimerQueue *timers : {&m_timers, &m_deadlines})
+                {
+                    next = (timers->empty() ? next : std::min(next, timers->top().due));
+                }
+                if (next == INT64_MAX)
+                {
+                    m_wake.wait(lock);
+                }
+                else
+                {
+                    m_wake.wait_for(lock, std::chrono::nanoseconds{next - now});
+                }
+            }
+        }
+
+        /// @brief runs the coroutine of a test until it suspends (or finishes), with the test's context
+        /// @param test the test
+        /// @param handle the coroutine (the test's own, or one it's awaiting)
+        /// @return true if the test has finished
+        bool resume(AsyncTest &test, std::coroutine_handle<> handle)
+        {
+            const PhaseTimer timer{RunnerPhase::capture};
+
+            std::streambuf *const previousTarget{ThreadRoutingBuffer::target()};
+#    ifndef bTESTS_NO_LOG
+            CaptureBuffer capture{test.result->log};
+            ThreadRoutingBuffer::target() = &capture;
+#    else
+            ThreadRoutingBuffer::target() = nullptr;
+#    endif // !bTESTS_NO_LOG
+            current_result()                         = test.result;
+            current_group()                          = test.testCase->group;
+            ben::tests::detail::current_async_test() = test.id;
+
+            // the CPU time and allocations add up over every resume (the peak and leaked bytes aren't measured, since
+            // the test's frame outlives each one)
+            const AllocationCounters &allocations{thread_allocations()};
+            const AllocationCounters  allocationsStart{allocations};
+            const double              cpuStart{get_thread_cpu_ns()};
+            {
+                const PhaseTimer body{RunnerPhase::tests};
+                handle.resume();
+            }
+            test.result->cpuNs += get_thread_cpu_ns() - cpuStart;
+            test.result->allocations += allocations.allocations - allocationsStart.allocations;
+            test.result->allocatedBytes += allocations.bytes - allocationsStart.bytes;
+
+            ben::tests::detail::current_async_test() = 0;
+            current_group()                          = {};
+            current_result()                         = nullptr;
+            ThreadRoutingBuffer::target()            = previousTarget;
+            return test.task.get_handle().done();
+        }
+
+        /// @brief completes the result of a test which has finished
+        /// @param test the test
+        void finish(AsyncTest &test)
+        {
+            TestResult &result{*test.result};
+#    ifndef bTESTS_NO_EXCEPTIONS
+            try
+            {
+                test.task.get_handle().promise().rethrow_if_failed();
+            }
+            catch (...)
+            {
+                record_current_exception(result);
+            }
+#    endif // !bTESTS_NO_EXCEPTIONS
+            result.status = (result.failures == 0 ? TestStatus::passed : TestStatus::failed);
+            result.wallNs = static_cast<double>(get_now_ns() - test.started);
+            test.onFinished();
+        }
+
+        /// @brief completes the result of a test which ran for longer than its timeout
+        /// @param test the test
+        void time_out(AsyncTest &test)
+        {
+            TestResult &result{*test.result};
+            result.status  = TestStatus::timed_out;
+            result.failure = "exceeded " + format_nanoseconds(get_timeout(*test.testCase) * 1e9) + "; abandoned";
+            result.wallNs  = static_cast<double>(get_now_ns() - test.started);
+            test.onFinished();
+        }
+
+        std::mutex                                     m_mutex;
+        std::condition_variable                        m_wake;
+        std::vector<std::thread>                       m_threads;
+        std::deque<Ready>                              m_ready;
+        TimerQueue                                     m_timers;
+        TimerQueue                                     m_deadlines;
+        std::map<uint64_t, std::unique_ptr<AsyncTest>> m_tests; // (the tests in flight, by id)
+        uint64_t                                       m_sequence{0};
+        uint64_t                                       m_lastId{0};
+        bool                                           m_stopping{false};
+    };
+
+    /// @brief the event loop which drives the async tests which run in this process
+    static EventLoop g_eventLoop{};
+
+    /// @brief runs a single test, capturing its output into the result
+    /// @param testCase the test to run
+    /// @param result the result of the test
+    void run_test_once(const TestCase &testCase, TestResult &result)
+    {
+        // async tests run on the event loop; this thread just waits for the result
+        if (testCase.asyncTest != nullptr)
+        {
+            std::latch finished{1};
+            g_eventLoop.start(testCase, result, [&finished]() { finished.count_down(); });
+            finished.wait();
+            return;
+        }
+
+        const std::string_view previousGroup{current_group()};
+        current_group() = testCase.group;
+        run_captured(result, testCase.func);
+        current_group() = previousGroup;
+    }
+
+    /// @brief runs one repetition of a test on "--stress" threads at once (or just once on this thread)
+    /// @param testCase the test to run
+    /// @param results the result of each thread's run (one per thread, this thread's first)
+    void run_test_round(const TestCase &testCase, std::vector<TestResult> &results)
+    {
+        if (results.size() == 1)
+        {
+            run_test_once(testCase, results[0]);
+            return;
+        }
+
+        // the threads wait for each other, so the runs overlap as much as they can
+        std::latch               ready{static_cast<std::ptrdiff_t>(results.size())};
+        std::vector<std::thread> threads;
+        threads.reserve(results.size() - 1);
+        for (size_t idx{1}; idx < results.size(); idx++)
+        {
+            threads.emplace_back([&, idx]() {
+                ready.arrive_and_wait();
+                run_test_once(testCase, results[idx]);
+            });
+        }
+        ready.arrive_and_wait();
+        run_test_once(testCase, results[0]);
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    /// @brief runs a test (as many times, and on as many threads, as "--repeat" and "--stress" ask for), capturing its
+    /// output
+    /// @param testCase the test to run
+    /// @param result the result of the test; when it runs more than once, the runs are aggregated into it (see
+    /// TestResult::runs), and it keeps the output of the first failing run (or of the first run, if none failed)
+    void run_test_captured(const TestCase &testCase, TestResult &result)
+    {
+        if (!is_repeating())
+        {
+            run_test_once(testCase, result);
+            return;
+        }
+
+        const size_t repeat{g_options.repeatUntilFail && !g_options.repeatGiven ? SIZE_MAX : g_options.repeat};
+
+        const auto              started{std::chrono::steady_clock::now()};
+        std::vector<TestResult> round(std::max<size_t>(g_options.stress, 1));
+        size_t                  runs{0};
+        size_t                  failedRuns{0};
+        double                  totalRunNs{0.0};
+        double                  cpuNs{0.0};
+        double                  minRunNs{0.0};
+        double                  maxRunNs{0.0};
+        for (size_t repetition{0}; repetition < repeat && !(g_options.repeatUntilFail && failedRuns > 0); repetition++)
+        {
+            std::fill(round.begin(), round.end(), TestResult{});
+            run_test_round(testCase, round);
+            for (TestResult &run : round)
+            {
+                const bool firstFailure{run.status != TestStatus::passed && failedRuns == 0};
+                failedRuns += (run.status != TestStatus::passed ? 1 : 0);
+                minRunNs = (runs == 0 ? run.wallNs : std::min(minRunNs, run.wallNs));
+                maxRunNs = std::max(maxRunNs, run.wallNs);
+                totalRunNs += run.wallNs;
+                cpuNs += run.cpuNs;
+                if (runs++ == 0 || firstFailure)
+                {
+                    result = std::move(run);
+                }
+            }
+        }
+
+        const std::chrono::duration<double, std::nano> elapsed{std::chrono::steady_clock::now() - started};
+        result.runs       = runs;
+        result.failedRuns = failedRuns;
+        result.minRunNs   = minRunNs;
+        result.meanRunNs  = totalRunNs / static_cast<double>(runs);
+        result.maxRunNs   = maxRunNs;
+        result.wallNs     = elapsed.count();
+        result.cpuNs      = cpuNs;
+    }
+
+    /// @brief watches the tests (and benchmarks) which are running, and ends the run if one of them runs for longer
+    /// than its timeout, or the whole run goes on for longer than the global timeout
+    ///
+    /// the runners record which test each worker slot is running (a few atomic stores per test; nothing is locked),
+    /// and a thread checks them every bTESTS_WATCHDOG_INTERVAL_MS. The thread is only started if there is a timeout to
+    /// enforce. Tests running in worker processes are timed out by the isolated runner instead (which only kills the
+    /// worker), so the watchdog only enforces the global timeout for them
+    class Watchdog
+    {
+      public:
+        Watchdog() = default;
+
+        Watchdog(const Watchdog &)            = delete;
+        Watchdog &operator=(const Watchdog &) = delete;
+
+        ~Watchdog()
+        {
+            stop();
+        }
+
+        /// @brief starts watching (the global timeout counts from here)
+        /// @param slots the number of slots (i.e. workers) which can run a test at the same time
+        void start(size_t slots)
+        {
+            m_slots      = std::make_unique<Slot[]>(slots);
+            m_slotCount  = slots;
+            m_runStarted = get_now_ns();
+
+            bool anyTimeout{g_options.globalTimeout > 0.0 || g_options.timeout > 0.0};
+            for (const std::vector<TestCase> *testCases : {&get_test_cases(), &get_benchmark_cases()})
+            {
+                for (const TestCase &testCase : *testCases)
+                {
+                    anyTimeout = anyTimeout || testCase.timeout > 0.0;
+                }
+            }
+            if (anyTimeout)
+            {
+                m_thread = std::make_unique<std::thread>([this]() { watch(); });
+            }
+        }
+
+        /// @brief stops watching
+        void stop()
+        {
+            if (m_thread == nullptr)
+            {
+                return;
+            }
+            m_stopping.store(true);
+            m_thread->join();
+            m_thread.reset();
+        }
+
+        /// @brief forgets about the watchdog thread without touching it (used by forked worker processes)
+        void abandon()
+        {
+            static_cast<void>(m_thread.release());
+            m_slotCount = 0;
+        }
+
+        /// @brief records that a slot has started running a test
+        /// @param slot the slot (i.e. worker) running the test
+        /// @param testCase the test
+        /// @param pid the worker process running the test (0 if it's running in this process)
+        void begin_test(size_t slot, const TestCase &testCase, long pid = 0)
+        {
+            if (slot < m_slotCount)
+            {
+                m_slots[slot].started.store(get_now_ns(), std::memory_order_relaxed);
+                m_slots[slot].pid.store(pid, std::memory_order_relaxed);
+                m_slots[slot].test.store(&testCase, std::memory_order_release);
+            }
+        }
+
+        /// @brief records that a slot has finished its test
+        /// @param slot the slot (i.e. worker) which ran the test
+        void end_test(size_t slot)
+        {
+            if (slot < m_slotCount)
+            {
+                m_slots[slot].test.store(nullptr, std::memory_order_release);
+            }
+        }
+
+      private:
+        /// @brief what a slot is running
+        struct Slot
+        {
+            std::atomic<const TestCase *> test{nullptr}; ///< the test being run (nullptr if idle)
+            std::atomic<int64_t>          started{0};    ///< when the test started (see get_now_ns())
+            std::atomic<long>             pid{0};        ///< the worker process running the test (0 if in-process)
+        };
+
+        /// @brief gets the time on a monotonic clock
+        /// @return the time (in nanoseconds since some arbitrary point)
+        static int64_t get_now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        /// @brief the body of the watchdog thread
+        /// @remark this sleeps rather than waiting on a condition variable: a worker process forked while the thread
+        /// was waiting could never destroy its copy of the condition variable
+        void watch()
+        {
+            while (!m_stopping.load())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds{bTESTS_WATCHDOG_INTERVAL_MS});
+                check();
+            }
+        }
+
+        /// @brief checks the timeouts, ending the run if any have passed
+        void check()
+        {
+            const int64_t now{get_now_ns()};
+            const double runNs{static_cast<double>(now - m_runStarted)};
+            if (g_options.globalTimeout > 0.0 && runNs >= g_options.globalTimeout * 1e9)
+            {
+                end_run("ERROR:\tThe run took longer than its global timeout (" +
+                        format_nanoseconds(g_options.globalTimeout * 1e9) + "); ending the run.\n");
+            }
+
+            for (size_t slot{0}; slot < m_slotCount; slot++)
+            {
+                const TestCase *const testCase{m_slots[slot].test.load(std::memory_order_acquire)};
+                // (the event loop times out async tests itself)
+                if (testCase == nullptr || m_slots[slot].pid.load(std::memory_order_relaxed) != 0 ||
+                    testCase->asyncTest != nullptr)
+                {
+                    continue;
+                }
+
+                // a slot may move on to its next test while we look at it; that only ever makes it look newer
+                const double elapsed{static_cast<double>(now - m_slots[slot].started.load(std::memory_order_relaxed))};
+                const double timeout{get_timeout(*testCase)};
+                if (timeout > 0.0 && elapsed >= timeout * 1e9 && m_slots[slot].test.load() == testCase)
+                {
+                    end_run(
+                        std::string{"ERROR:\t"}
+                            .append(testCase->benchmark != nullptr ? "Benchmark '" : "Test '")
+                            .append(testCase->group)
+                            .append("' / '")
+                            .append(testCase->name)
+                            .append("' ran for longer than its timeout (")
+                            .append(format_nanoseconds(timeout * 1e9))
+                            .append("); ending the run.\n"));
+                }
+            }
+        }
+
+        /// @brief reports a timeout (along with everything which was still running), then ends the application
+        /// @param message the description of the timeout
+        /// @remark the tests which are still running can't be stopped safely, so the application ends without
+        /// unwinding; the log is written out first, and any worker processes are killed
+        [[noreturn]] void end_run(std::string message)
+        {
+            const int64_t now{get_now_ns()};
+            message.append("INFO:\tStill running:\n");
+            for (size_t slot{0}; slot < m_slotCount; slot++)
+            {
+                const TestCase *const testCase{m_slots[slot].test.load(std::memory_order_acquire)};
+                if (testCase != nullptr)
+                {
+                    const double elapsed{static_cast<double>(now - m_slots[slot].started.load())};
+                    message.append("\t'").append(testCase->group).append("' / '").append(testCase->name);
+                    message.append("' (for ").append(format_nanoseconds(elapsed));
+                    if (m_slots[slot].pid.load() != 0)
+                    {
+                        message.append(", in worker process ").append(std::to_string(m_slots[slot].pid.load()));
+                    }
+                    message.append(")\n");
+                }
+            }
+
+            // std::cout only prints to the console from the main thread, so write to stdout directly
+            std::fwrite(message.data(), 1, message.size(), stdout);
+            std::fflush(stdout);
+#    ifndef bTESTS_NO_LOG
+            g_testsLog.write_unwritten(message);
+#    endif // !bTESTS_NO_LOG
+#    ifndef _WIN32
+            for (size_t slot{0}; slot < m_slotCount; slot++)
+            {
+                if (m_slots[slot].test.load() != nullptr && m_slots[slot].pid.load() > 0)
+                {
+                    ::kill(static_cast<pid_t>(m_slots[slot].pid.load()), SIGKILL);
+                }
+            }
+#    endif // !_WIN32
+            std::_Exit(static_cast<int>(ReturnValue::fail));
+        }
+
+        std::unique_ptr<Slot[]>      m_slots;
+        size_t                       m_slotCount{0};
+        int64_t                      m_runStarted{0};
+        std::atomic<bool>            m_stopping{false};
+        std::unique_ptr<std::thread> m_thread; // (heap allocated, so a forked child can abandon it)
+    };
+
+    /// @brief the watchdog which enforces the timeouts of the tests which run in this process (and the global timeout)
+    static Watchdog g_watchdog{};
+
+    /// @brief appends the outcome of a test (e.g. "passed.") to a string
+    /// @param output the string to append to
+    /// @param result the result of the test
+    void append_outcome(std::string &output, const TestResult &result)
+    {
+        switch (result.status)
+        {
+        case TestStatus::passed:
+            output.append("passed.");
+            break;
+        case TestStatus::failed:
+            output.append("failed at '").append(result.failure).append("'");
+            if (!result.expression.empty())
+            {
+                output.append(" (").append(result.expression).append(")");
+            }
+            if (result.failures > 1)
+            {
+                output.append(", plus ").append(std::to_string(result.failures - 1)).append(" more failure");
+                output.append(result.failures == 2 ? "" : "s");
+            }
+            output.append(".");
+            break;
+        case TestStatus::crashed:
+            output.append("crashed (").append(result.failure).append(").");
+            break;
+        case TestStatus::timed_out:
+            output.append("timed out (").append(result.failure).append(").");
+            break;
+        }
+        output.append(" [").append(format_nanoseconds(result.wallNs)).append(" wall, ");
+        output.append(format_nanoseconds(result.cpuNs)).append(" cpu");
+        if (result.counters.events != 0)
+        {
+            output.append(", ").append(describe_counters(result.counters, 1.0, ""));
+        }
+#    ifdef bTESTS_TRACK_ALLOCATIONS
+        output.append(", ").append(std::to_string(result.allocations));
+        output.append(result.allocations == 1 ? " allocation (" : " allocations (");
+        output.append(std::to_string(result.allocatedBytes)).append(" bytes, peak ");
+        output.append(std::to_string(result.peakBytes)).append(" bytes)");
+        if (result.leakedBytes > 0)
+        {
+            output.append(", leaked ").append(std::to_string(result.leakedBytes)).append(" bytes");
+        }
+#    endif // bTESTS_TRACK_ALLOCATIONS
+        output.append("]\n");
+    }
+
+    /// @brief the group of the last failure printed with "--quiet" (whose header has already been printed)
+    static std::string_view g_quietGroup{};
+
+    /// @brief the failures which are waiting to be written to the console along with the next redraw of the progress
+    /// line (with "--quiet"), so the console gets one write every bTESTS_PROGRESS_INTERVAL_MS at most
+    static std::string g_consoleBatch{};
+
+    /// @brief when the progress line was last drawn (with "--quiet")
+    static std::chrono::steady_clock::time_point g_lastProgress{};
+
+    /// @brief whether the progress line is on the console (so it has to be erased before anything else is written)
+    static bool g_progressShown{false};
+
+    /// @brief checks whether the console is a terminal (so it makes sense to redraw a progress line in place)
+    /// @return true if std::cout goes to a terminal
+    bool is_console_terminal()
+    {
+#    ifdef _WIN32
+        static const bool s_terminal{_isatty(_fileno(stdout)) != 0};
 #    else
-                std::cout.set_rdbuf(nullptr);
+        static const bool s_terminal{isatty(fileno(stdout)) != 0};
+#    endif // _WIN32
+        return s_terminal;
+    }
+
+    /// @brief writes the batched console output, then redraws the progress line (with "--quiet")
+    /// @param reported how many tests have been reported so far
+    /// @param force whether to write even if the progress line was drawn less than bTESTS_PROGRESS_INTERVAL_MS ago
+    /// @remark the progress line is only drawn on a terminal; otherwise (e.g. in CI logs) only the batched failures
+    /// are written. Once every test has been reported the progress line is erased for good
+    void update_progress(size_t reported, bool force)
+    {
+        if (!g_options.quiet)
+        {
+            return;
+        }
+        const std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+        if (!force && now - g_lastProgress < std::chrono::milliseconds{bTESTS_PROGRESS_INTERVAL_MS})
+        {
+            return;
+        }
+        g_lastProgress = now;
+
+        std::string output;
+        if (g_progressShown && (!g_consoleBatch.empty() || reported == get_number_of_tests()))
+        {
+            output.append("\r").append(79, ' ').append("\r");
+            g_progressShown = false;
+        }
+        output.append(g_consoleBatch);
+        g_consoleBatch.clear();
+        if (is_console_terminal() && reported < get_number_of_tests())
+        {
+            output.append(output.empty() && g_progressShown ? "\r" : "");
+            output.append("\t").append(std::to_string(reported)).append(" / ");
+            output.append(std::to_string(get_number_of_tests())).append(" tests, ");
+            output.append(std::to_string(g_failuresSoFar)).append(" failed");
+            g_progressShown = true;
+        }
+        std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+        std::cout.flush();
+    }
+
+    /// @brief reports the result of a single test (or benchmark) to the console and to the log file
+    /// @param testCase the test which was run
+    /// @param number the (1-based) number of the test, as printed to the console
+    /// @param newGroup whether the test is the first one in its group (and so the group header should be printed)
+    /// @param result the result of the test
+    /// @param details extra information to print after the outcome of the test (if not empty)
+    void report_case(
+        const TestCase   &testCase,
+        size_t            number,
+        bool              newGroup,
+        const TestResult &result,
+        std::string_view  details = {})
+    {
+        // build everything up front so the console and the log file each get a single write per test
+        std::string console;
+        if (newGroup)
+        {
+            console.append("Group: '").append(testCase.group).append("'\n");
+        }
+
+#    ifndef bTESTS_NO_LOG
+        std::string entry{console};
+        entry.append("--------------------------------------------------------------------------------\n");
+        entry.append(testCase.benchmark != nullptr ? "Benchmark '" : "Test '").append(testCase.name);
+        entry.append("' log:\n\n").append(result.log).append("\n");
+        append_outcome(entry, result);
+        if (!details.empty())
+        {
+            entry.append(details).append("\n");
+        }
+        entry.append("--------------------------------------------------------------------------------\n");
+        {
+            const PhaseTimer timer{RunnerPhase::log};
+            get_tests_log().write(entry.data(), static_cast<std::streamsize>(entry.size()));
+        }
 #    endif // !bTESTS_NO_LOG
 
-                // use exceptions to figure out if tests pass
-                try
-                {
-                    test();
+        // with "--quiet" only the failing tests reach the console (under the header of their group)
+        if (g_options.quiet && testCase.benchmark == nullptr)
+        {
+            if (result.status == TestStatus::passed)
+            {
+                return;
+            }
+            console.clear();
+            if (g_quietGroup != testCase.group)
+            {
+                console.append("Group: '").append(testCase.group).append("'\n");
+                g_quietGroup = testCase.group;
+            }
+        }
+
+        console.append("\t[").append(std::to_string(number)).append("] : '").append(testCase.name).append("' ");
+        append_outcome(console, result);
+        if (!details.empty())
+        {
+            console.append("\t\t").append(details).append("\n");
+        }
+        if (g_options.quiet && testCase.benchmark == nullptr)
+        {
+            g_consoleBatch.append(console);
+            return;
+        }
+        std::cout.write(console.data(), static_cast<std::streamsize>(console.size()));
+    }
+
+    /// @brief describes the runs of a test which ran more than once (see "--repeat" and "--stress")
+    /// @param result the (aggregated) result of the test
+    /// @return the description, e.g. "ran 1000 times (2 failed); per run: 1.20 us min, 1.50 us mean, 30.00 us max", or
+    /// an empty string if the test only ran once
+    std::string describe_runs(const TestResult &result)
+    {
+        if (result.runs <= 1)
+        {
+            return {};
+        }
+        std::string description{"ran "};
+        description.append(std::to_string(result.runs)).append(" times (");
+        description.append(std::to_string(result.failedRuns)).append(" failed); per run: ");
+        description.append(format_nanoseconds(result.minRunNs)).append(" min, ");
+        description.append(format_nanoseconds(result.meanRunNs)).append(" mean, ");
+        description.append(format_nanoseconds(result.maxRunNs)).append(" max");
+        return description;
+    }
+
+    /// @brief counts a test which has just finished towards the "--fail-fast" limit
+    /// @param result the result of the test
+    /// @note called as soon as the test finishes (from whichever thread ran it), rather than when it's reported
+    void count_failure(const TestResult &result)
+    {
+        if (result.status == TestStatus::passed)
+        {
+            return;
+        }
+        const size_t failures{g_failuresSoFar.fetch_add(1) + 1};
+        if (g_options.failFast > 0 && failures >= g_options.failFast)
+        {
+            g_stopStarting = true;
+        }
+    }
+
+    /// @brief keeps what a test (or a benchmark) measured, to append to the trend file once the run is over
+    /// @param testCase the test
+    /// @param result the result of the test
+    /// @param counters the hardware events counted
+    /// @param time the time to record (see TrendMetric::time)
+    /// @param operations what to divide the counters by (the number of iterations, for a benchmark)
+    void add_trend_record(const TestCase &testCase, const TestResult &result, const CounterValues &counters,
+                          double time, double operations)
+    {
+        if (g_options.trendFile.empty())
+        {
+            return;
+        }
+
+        TrendRecord record{hash_test_case(testCase), static_cast<uint8_t>(result.status), {}};
+        record.flags |= (testCase.benchmark != nullptr ? TrendRecord::benchmarkFlag : 0);
+        record.flags |= ((counters.events & CounterValues::tscEvent) != 0 ? TrendRecord::tscFlag : 0);
+        const auto set = [&record](TrendMetric metric, double value) {
+            record.metrics[static_cast<size_t>(metric)] = static_cast<float>(value);
+        };
+        set(TrendMetric::time, time);
+        set(TrendMetric::cpu, result.cpuNs);
+        set(TrendMetric::allocations, static_cast<double>(result.allocations));
+        set(TrendMetric::bytes, static_cast<double>(result.allocatedBytes));
+        set(TrendMetric::cycles, counters.cycles / operations);
+        set(TrendMetric::instructions, counters.instructions / operations);
+        set(TrendMetric::cacheMisses, counters.cacheMisses / operations);
+        set(TrendMetric::branchMisses, counters.branchMisses / operations);
+        g_trendRecords.push_back(record);
+    }
+
+    /// @brief reports the result of a single test to the console and to the log file
+    /// @param idx the index of the test (in get_test_cases())
+    /// @param result the result of the test
+    /// @note must be called in order (the group header is printed whenever the group differs from the previous test's)
+    void report_result(size_t idx, const TestResult &result)
+    {
+        const PhaseTimer timer{RunnerPhase::reporting};
+        if (result.status == TestStatus::passed)
+        {
+            g_successes++;
+        }
+
+        g_timings.resize(get_test_cases().size());
+        g_timings[idx] = TestTiming{result.wallNs, result.cpuNs, result.status, true};
+        add_trend_record(get_test_cases()[idx], result, result.counters,
+                         result.runs > 1 ? result.meanRunNs : result.wallNs, 1.0);
+
+        const bool newGroup{idx == 0 || get_test_cases()[idx - 1].group != get_test_cases()[idx].group};
+        report_case(get_test_cases()[idx], idx + 1, newGroup, result, describe_runs(result));
+        for (const std::unique_ptr<Reporter> &reporter : g_reporters)
+        {
+            reporter->report_test(get_test_cases()[idx], result);
+        }
+
+        // results are reported in order, so once the last test in a group is reported the whole group has finished
+        const bool lastInGroup{
+            idx + 1 == get_test_cases().size() || get_test_cases()[idx + 1].group != get_test_cases()[idx].group};
+        if (lastInGroup)
+        {
+            tear_down_fixtures(&get_test_cases()[idx].group);
+        }
+
+        // failures are shown straight away; passes only move the (throttled) progress line along
+        update_progress(idx + 1, result.status != TestStatus::passed);
+    }
+
+    /// @brief evaluate the tests on a pool of worker threads, reporting the results in order as they come in
+    void run_tests_parallel()
+    {
+        const std::vector<TestCase> &testCases{get_test_cases()};
+        const size_t                 jobs{get_number_of_jobs()};
+
+        std::vector<TestResult> results(testCases.size());
+        std::vector<bool>       finished(testCases.size(), false);
+        std::vector<bool>       ran(testCases.size(), false);
+        std::mutex              resultsMutex;
+        std::condition_variable resultsReady;
+
+        // deal the tests out to the workers round-robin, slowest first (if there's a history) so the run doesn't wait
+        // on a long test at the end; otherwise in order, so the first tests finish first and the (in order) results
+        // keep flowing while the workers steal from each other
+        const std::vector<size_t> order{get_start_order()};
+        std::vector<WorkQueue>    queues(jobs);
+        for (size_t idx{0}; idx < order.size(); idx++)
+        {
+            queues[idx % jobs].push(order[idx]);
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(jobs);
+        for (size_t worker{0}; worker < jobs; worker++)
+        {
+            workers.emplace_back([&, worker]() {
+                // take work from our own queue first, then try to steal from the other workers
+                const auto pop = [&](size_t &popped) {
+                    bool found{queues[worker].pop(popped)};
+                    for (size_t offset{1}; !found && offset < jobs; offset++)
+                    {
+                        found = queues[(worker + offset) % jobs].steal(popped);
+                    }
+                    return found;
+                };
+
+                size_t idx{0};
+                while (true)
+                {
+                    // nothing is ever added to the queues once the workers start, so if every queue is empty (and no
+                    // test is waiting for the gate) we're done
+                    const PhaseTimer timer{RunnerPhase::scheduling};
+                    if (!(g_resourceGate.is_enabled() ? g_resourceGate.next(pop, idx, true) : pop(idx)))
+                    {
+                        return;
+                    }
+
+                    // once the run is stopping the rest of the tests are drained from the queues without running them
+                    const bool run{!g_stopStarting};
+                    if (run && testCases[idx].asyncTest != nullptr && !is_repeating())
+                    {
+                        // async tests are started on the event loop, which hands the result over once it's final
+                        g_eventLoop.start(testCases[idx], results[idx], [&, idx]() {
+                            count_failure(results[idx]);
+                            g_resourceGate.release(idx);
+                            std::lock_guard lock{resultsMutex};
+                            finished[idx] = true;
+                            ran[idx]      = true;
+                            resultsReady.notify_one();
+                        });
+                        continue;
+                    }
+                    if (run)
+                    {
+                        g_watchdog.begin_test(worker, testCases[idx]);
+                        run_test_captured(testCases[idx], results[idx]);
+                        g_watchdog.end_test(worker);
+                        count_failure(results[idx]);
+                    }
+                    g_resourceGate.release(idx);
+
+                    {
+                        std::lock_guard lock{resultsMutex};
+                        finished[idx] = true;
+                        ran[idx]      = run;
+                    }
+                    resultsReady.notify_one();
+                }
+            });
+        }
+
+        // report the results in order, waiting for each one to finish
+        for (size_t idx{0}; idx < testCases.size(); idx++)
+        {
+            {
+                std::unique_lock lock{resultsMutex};
+                resultsReady.wait(lock, [&]() { return finished[idx]; });
+                if (!ran[idx])
+                {
+                    g_testsNotRun++;
+                    continue;
+                }
+            }
+            report_result(idx, results[idx]);
+
+            // the log has been written, so there's no need to hold on to it until the end of the run
+            results[idx].log = std::string{};
+        }
+
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+#    ifndef _WIN32
+    /// @brief a worker process which runs tests (one at a time) on behalf of the "parent" test application
+    struct WorkerProcess
+    {
+        pid_t                                 pid{-1};          ///< the worker's process id
+        int                                   toWorker{-1};     ///< pipe the test indices are written to
+        int                                   fromWorker{-1};   ///< pipe the (serialized) results are read from
+        size_t                                testIdx{SIZE_MAX}; ///< the test the worker is running (SIZE_MAX if idle)
+        std::chrono::steady_clock::time_point started{};        ///< when the worker was handed its current test
+        std::string                           received;         ///< the (partial) result read from the worker so far
+    };
+
+    /// @brief writes an entire buffer to a file descriptor
+    /// @param fd the file descriptor to write to
+    /// @param data the data to write
+    /// @param size the number of bytes to write
+    /// @return true if everything was written, false if the other end has gone away
+    bool write_all(int fd, const void *data, size_t size)
+    {
+        const char *bytes{static_cast<const char *>(data)};
+        while (size > 0)
+        {
+            const ssize_t written{::write(fd, bytes, size)};
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    /// @brief reads an entire buffer from a file descriptor
+    /// @param fd the file descriptor to read from
+    /// @param data where to read the data into
+    /// @param size the number of bytes to read
+    /// @return true if everything was read, false if the other end has gone away
+    bool read_all(int fd, void *data, size_t size)
+    {
+        char *bytes{static_cast<char *>(data)};
+        while (size > 0)
+        {
+            const ssize_t count{::read(fd, bytes, size)};
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                return false;
+            }
+            bytes += count;
+            size -= static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    /// @brief appends a (fixed width) value to a serialized result
+    /// @param output the serialized result
+    /// @param value the value to append
+    template <typename T>
+    void append_raw(std::string &output, const T &value)
+    {
+        output.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    /// @brief appends a (length prefixed) string to a serialized result
+    /// @param output the serialized result
+    /// @param value the string to append
+    void append_raw_string(std::string &output, std::string_view value)
+    {
+        append_raw(output, static_cast<uint64_t>(value.size()));
+        output.append(value);
+    }
+
+    /// @brief reads a (fixed width) value from a serialized result
+    /// @param input the (remaining) serialized result; advanced past the value
+    /// @param value set to the value read
+    /// @return true if there was enough input
+    template <typename T>
+    bool read_raw(std::string_view &input, T &value)
+    {
+        if (input.size() < sizeof(value))
+        {
+            return false;
+        }
+        std::memcpy(&value, input.data(), sizeof(value));
+        input.remove_prefix(sizeof(value));
+        return true;
+    }
+
+    /// @brief reads a (length prefixed) string from a serialized result
+    /// @param input the (remaining) serialized result; advanced past the string
+    /// @param value set to the string read
+    /// @return true if there was enough input
+    bool read_raw_string(std::string_view &input, std::string &value)
+    {
+        uint64_t size{0};
+        if (!read_raw(input, size) || input.size() < size)
+        {
+            return false;
+        }
+        value.assign(input.substr(0, static_cast<size_t>(size)));
+        input.remove_prefix(static_cast<size_t>(size));
+        return true;
+    }
+
+    /// @brief serializes a result so it can be sent from a worker process to the parent
+    /// @param result the result to serialize
+    /// @return the serialized result, prefixed by its length
+    std::string serialize_result(const TestResult &result)
+    {
+        std::string body;
+        append_raw(body, static_cast<uint64_t>(result.status));
+        append_raw_string(body, result.failure);
+        append_raw_string(body, result.expression);
+        append_raw_string(body, result.log);
+        append_raw(body, static_cast<uint64_t>(result.failures));
+        append_raw(body, result.wallNs);
+        append_raw(body, result.cpuNs);
+        append_raw(body, static_cast<uint64_t>(result.allocations));
+        append_raw(body, static_cast<uint64_t>(result.allocatedBytes));
+        append_raw(body, static_cast<uint64_t>(result.peakBytes));
+        append_raw(body, static_cast<uint64_t>(result.leakedBytes));
+        append_raw(body, static_cast<uint64_t>(result.counters.events));
+        append_raw(body, result.counters.cycles);
+        append_raw(body, result.counters.instructions);
+        append_raw(body, result.counters.cacheMisses);
+        append_raw(body, result.counters.branchMisses);
+        append_raw(body, static_cast<uint64_t>(result.runs));
+        append_raw(body, static_cast<uint64_t>(result.failedRuns));
+        append_raw(body, result.minRunNs);
+        append_raw(body, result.meanRunNs);
+        append_raw(body, result.maxRunNs);
+
+        std::string message;
+        append_raw_string(message, body);
+        return message;
+    }
+
+    /// @brief deserializes a result sent by a worker process, if all of it has arrived
+    /// @param received everything received from the worker so far; the result is removed from the front of it
+    /// @param result set to the deserialized result
+    /// @return true if a whole result was received (and deserialized)
+    bool deserialize_result(std::string &received, TestResult &result)
+    {
+        std::string_view input{received};
+        uint64_t         size{0};
+        if (!read_raw(input, size) || input.size() < size)
+        {
+            return false;
+        }
+
+        std::string_view body{input.substr(0, static_cast<size_t>(size))};
+        uint64_t         status{0};
+        uint64_t         failures{0};
+        uint64_t         allocations[4]{};
+        read_raw(body, status);
+        read_raw_string(body, result.failure);
+        read_raw_string(body, result.expression);
+        read_raw_string(body, result.log);
+        read_raw(body, failures);
+        read_raw(body, result.wallNs);
+        read_raw(body, result.cpuNs);
+        for (uint64_t &value : allocations)
+        {
+            read_raw(body, value);
+        }
+        uint64_t events{0};
+        read_raw(body, events);
+        read_raw(body, result.counters.cycles);
+        read_raw(body, result.counters.instructions);
+        read_raw(body, result.counters.cacheMisses);
+        read_raw(body, result.counters.branchMisses);
+        uint64_t runs[2]{1, 0};
+        read_raw(body, runs[0]);
+        read_raw(body, runs[1]);
+        read_raw(body, result.minRunNs);
+        read_raw(body, result.meanRunNs);
+        read_raw(body, result.maxRunNs);
+        result.runs            = static_cast<size_t>(runs[0]);
+        result.failedRuns      = static_cast<size_t>(runs[1]);
+        result.counters.events = static_cast<unsigned>(events);
+        result.status         = static_cast<TestStatus>(status);
+        result.failures       = static_cast<size_t>(failures);
+        result.allocations    = static_cast<size_t>(allocations[0]);
+        result.allocatedBytes = static_cast<size_t>(allocations[1]);
+        result.peakBytes      = static_cast<size_t>(allocations[2]);
+        result.leakedBytes    = static_cast<size_t>(allocations[3]);
+
+        received.erase(0, sizeof(size) + static_cast<size_t>(size));
+        return true;
+    }
+
+    /// @brief the loop run by a worker process: read a test index, run the test, write the result back, repeat
+    /// @param fromParent the pipe to read test indices from
+    /// @param toParent the pipe to write the (serialized) results to
+    /// @note never returns; the worker exits (without flushing anything inherited from the parent) once the parent
+    /// closes its end of the pipe
+    [[noreturn]] void run_worker_process(int fromParent, int toParent)
+    {
+        uint64_t idx{0};
+        while (read_all(fromParent, &idx, sizeof(idx)))
+        {
+            TestResult result;
+            run_test_captured(get_test_cases()[idx], result);
+
+            const std::string message{serialize_result(result)};
+            if (!write_all(toParent, message.data(), message.size()))
+            {
+                break;
+            }
+        }
+
+        // the fixtures a worker builds live (and are shared by the tests it runs) until the worker exits
+        tear_down_fixtures(nullptr);
+        ::_exit(0);
+    }
+
+    /// @brief starts a (new) worker process
+    /// @param workers all of the workers (the new worker must not hold on to the other workers' pipes)
+    /// @param worker the worker to start
+    /// @return true if the worker was started
+    bool spawn_worker(std::vector<WorkerProcess> &workers, WorkerProcess &worker)
+    {
+        int toWorker[2]{-1, -1};
+        int fromWorker[2]{-1, -1};
+        if (::pipe(toWorker) != 0)
+        {
+            return false;
+        }
+        if (::pipe(fromWorker) != 0)
+        {
+            ::close(toWorker[0]);
+            ::close(toWorker[1]);
+            return false;
+        }
+
+        // anything still buffered would otherwise be written twice (once by each process)
+        std::cout.flush();
+#        ifndef bTESTS_NO_LOG
+        g_testsLog.flush();
+#        endif // !bTESTS_NO_LOG
+        for (const std::unique_ptr<Reporter> &reporter : g_reporters)
+        {
+            reporter->flush();
+        }
+
+        const pid_t pid{::fork()};
+        if (pid == 0)
+        {
+            for (const WorkerProcess &other : workers)
+            {
+                if (other.pid > 0)
+                {
+                    ::close(other.toWorker);
+                    ::close(other.fromWorker);
+                }
+            }
+            ::close(toWorker[1]);
+            ::close(fromWorker[0]);
+#        ifndef bTESTS_NO_LOG
+            // the log belongs to the parent; a crashing test must not write the parent's buffers out a second time
+            for (const int signal : g_crashSignals)
+            {
+                std::signal(signal, SIG_DFL);
+            }
+            g_testsLog.abandon();
+#        endif // !bTESTS_NO_LOG
+            g_watchdog.abandon();
+            thread_counters().close();
+            run_worker_process(toWorker[0], fromWorker[1]);
+        }
+
+        ::close(toWorker[0]);
+        ::close(fromWorker[1]);
+        if (pid < 0)
+        {
+            ::close(toWorker[1]);
+            ::close(fromWorker[0]);
+            return false;
+        }
+
+        worker            = WorkerProcess{};
+        worker.pid        = pid;
+        worker.toWorker   = toWorker[1];
+        worker.fromWorker = fromWorker[0];
+        return true;
+    }
+
+    /// @brief closes the pipes to a worker and waits for it to exit
+    /// @param worker the worker to stop
+    /// @return the exit status of the worker (as from waitpid)
+    int reap_worker(WorkerProcess &worker)
+    {
+        ::close(worker.toWorker);
+        ::close(worker.fromWorker);
+        int status{0};
+        while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+        worker.pid = -1;
+        return status;
+    }
+
+    /// @brief describes how a worker process died
+    /// @param status the exit status of the worker (as from waitpid)
+    /// @return a description of the signal or exit code
+    std::string describe_exit_status(int status)
+    {
+        if (WIFSIGNALED(status))
+        {
+            const char *const name{::strsignal(WTERMSIG(status))};
+            return "signal " + std::to_string(WTERMSIG(status)) + (name != nullptr ? std::string{": "} + name : "");
+        }
+        return "exited with code " + std::to_string(WEXITSTATUS(status));
+    }
+
+    /// @brief evaluate the tests in a pool of worker processes, so a test which crashes only fails itself
+    ///
+    /// the workers are forked up front and each one runs many tests, so the cost of a fork is only paid again when a
+    /// worker has to be replaced (because its test crashed or timed out)
+    void run_tests_isolated()
+    {
+        const std::vector<TestCase> &testCases{get_test_cases()};
+
+        std::vector<TestResult>   results(testCases.size());
+        std::vector<bool>         finished(testCases.size(), false);
+        std::vector<bool>         ran(testCases.size(), true);
+        const std::vector<size_t> order{get_start_order()}; // the tests are handed out in this order
+        size_t                    nextTest{0};              // the position (in order) of the next test to hand out
+        size_t                    nextReport{0};
+
+        // a worker which dies while idle must not take the whole application with it
+        ::signal(SIGPIPE, SIG_IGN);
+
+        std::vector<WorkerProcess> workers(get_number_of_jobs());
+        for (WorkerProcess &worker : workers)
+        {
+            if (!spawn_worker(workers, worker))
+            {
+                std::cout << "ERROR:\tCould not start a worker process.\n";
+            }
+        }
+
+        const auto finish = [&](WorkerProcess &worker, TestResult result) {
+            g_watchdog.end_test(static_cast<size_t>(&worker - workers.data()));
+            count_failure(result);
+            g_resourceGate.release(worker.testIdx);
+            results[worker.testIdx]  = std::move(result);
+            finished[worker.testIdx] = true;
+            worker.testIdx           = SIZE_MAX;
+            worker.received.clear();
+        };
+
+        // a result for tests which never reported back (the time is as seen by this process)
+        const auto lost = [](const WorkerProcess &worker, TestStatus status, std::string failure) {
+            TestResult result;
+            result.status  = status;
+            result.failure = std::move(failure);
+            result.wallNs  = std::chrono::duration<double, std::nano>{std::chrono::steady_clock::now() - worker.started}
+                                .count();
+            return result;
+        };
+
+        const auto replace = [&](WorkerProcess &worker) {
+            if (!spawn_worker(workers, worker))
+            {
+                std::cout << "ERROR:\tCould not restart a worker process.\n";
+            }
+        };
+
+        while (nextReport < testCases.size())
+        {
+            // once the run is stopping, the tests which haven't been handed out yet (or are waiting for the gate)
+            // won't be
+            for (; g_stopStarting && nextTest < testCases.size(); nextTest++)
+            {
+                finished[order[nextTest]] = true;
+                ran[order[nextTest]]      = false;
+            }
+            for (size_t waiting{0}; g_stopStarting && g_resourceGate.take_waiting(waiting);)
+            {
+                finished[waiting] = true;
+                ran[waiting]      = false;
+            }
+
+            // hand out work to the idle workers (as long as the gate lets the next test start)
+            const auto pop = [&](size_t &popped) {
+                if (nextTest >= testCases.size())
+                {
+                    return false;
+                }
+                popped = order[nextTest++];
+                return true;
+            };
+            for (WorkerProcess &worker : workers)
+            {
+                if (worker.pid <= 0 || worker.testIdx != SIZE_MAX)
+                {
+                    continue;
+                }
+                size_t next{0};
+                if (!(g_resourceGate.is_enabled() ? g_resourceGate.next(pop, next, false) : pop(next)))
+                {
+                    break;
+                }
+                const uint64_t idx{next};
+                if (!write_all(worker.toWorker, &idx, sizeof(idx)))
+                {
+                    // the worker died while it was idle; replace it and try again on the next pass
+                    reap_worker(worker);
+                    replace(worker);
+                    if (g_resourceGate.is_enabled())
+                    {
+                        g_resourceGate.put_back(next);
+                    }
+                    else
+                    {
+                        nextTest--;
+                    }
+                    continue;
+                }
+                worker.testIdx = next;
+                worker.started = std::chrono::steady_clock::now();
+                g_watchdog.begin_test(
+                    static_cast<size_t>(&worker - workers.data()), testCases[worker.testIdx], worker.pid);
+            }
+
+            // wait for a result (waking up in time to enforce the timeout, if there is one)
+            std::vector<pollfd> fds;
+            std::vector<size_t> owners;
+            int                 waitMs{-1};
+            for (size_t idx{0}; idx < workers.size(); idx++)
+            {
+                if (workers[idx].pid <= 0 || workers[idx].testIdx == SIZE_MAX)
+                {
+                    continue;
+                }
+                fds.push_back(pollfd{workers[idx].fromWorker, POLLIN, 0});
+                owners.push_back(idx);
+
+                const double timeout{get_timeout(testCases[workers[idx].testIdx])};
+                if (timeout > 0.0)
+                {
+                    const std::chrono::duration<double> elapsed{
+                        std::chrono::steady_clock::now() - workers[idx].started};
+                    const int remainingMs{static_cast<int>((timeout - elapsed.count()) * 1000.0) + 1};
+                    waitMs = (waitMs < 0 ? std::max(remainingMs, 0) : std::min(waitMs, std::max(remainingMs, 0)));
+                }
+            }
+
+            if (fds.empty())
+            {
+                // no worker could be (re)started, so neither the remaining tests nor those the gate set aside can run
+                for (; nextTest < testCases.size(); nextTest++)
+                {
+                    results[order[nextTest]].status  = TestStatus::crashed;
+                    results[order[nextTest]].failure = "no worker process available";
+                    finished[order[nextTest]]        = true;
+                }
+                for (size_t waiting{0}; g_resourceGate.take_waiting(waiting);)
+                {
+                    results[waiting].status  = TestStatus::crashed;
+                    results[waiting].failure = "no worker process available";
+                    finished[waiting]        = true;
+                }
+            }
+            else if (::poll(fds.data(), static_cast<nfds_t>(fds.size()), waitMs) < 0 && errno != EINTR)
+            {
+                std::cout << "ERROR:\tFailed to wait on the worker processes.\n";
+                break;
+            }
+
+            for (size_t idx{0}; idx < fds.size(); idx++)
+            {
+                WorkerProcess &worker{workers[owners[idx]]};
+
+                if ((fds[idx].revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+                {
+                    char          buffer[65536];
+                    const ssize_t count{::read(worker.fromWorker, buffer, sizeof(buffer))};
+                    if (count > 0)
+                    {
+                        worker.received.append(buffer, static_cast<size_t>(count));
+
+                        TestResult result;
+                        if (deserialize_result(worker.received, result))
+                        {
+                            finish(worker, std::move(result));
+                        }
+                        continue;
+                    }
+                    if (count < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    // the worker died part way through the test
+                    const int status{reap_worker(worker)};
+                    finish(worker, lost(worker, TestStatus::crashed, describe_exit_status(status)));
+                    replace(worker);
+                    continue;
+                }
+
+                const double timeout{get_timeout(testCases[worker.testIdx])};
+                if (timeout > 0.0)
+                {
+                    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - worker.started};
+                    if (elapsed.count() >= timeout)
+                    {
+                        ::kill(worker.pid, SIGKILL);
+                        reap_worker(worker);
+                        finish(
+                            worker,
+                            lost(
+                                worker,
+                                TestStatus::timed_out,
+                                "exceeded " + format_nanoseconds(timeout * 1e9) + "; worker killed"));
+                        replace(worker);
+                    }
+                }
+            }
+
+            // report whatever has finished (in order)
+            for (; nextReport < testCases.size() && finished[nextReport]; nextReport++)
+            {
+                if (!ran[nextReport])
+                {
+                    g_testsNotRun++;
+                    continue;
+                }
+                report_result(nextReport, results[nextReport]);
+                results[nextReport].log = std::string{};
+            }
+        }
+
+        for (WorkerProcess &worker : workers)
+        {
+            if (worker.pid > 0)
+            {
+                reap_worker(worker);
+            }
+        }
+    }
+#    endif // !_WIN32
+
+    /// @brief evaluate the tests one after another on the calling thread
+    void run_tests_serial()
+    {
+        const std::vector<TestCase> &testCases{get_test_cases()};
+
+        for (size_t idx{0}; idx < testCases.size(); idx++)
+        {
+            // whatever the test and its report don't account for is the runner's scheduling
+            const PhaseTimer timer{RunnerPhase::scheduling};
+            if (g_stopStarting)
+            {
+                g_testsNotRun = testCases.size() - idx;
+                break;
+            }
+
+            TestResult result;
+            g_watchdog.begin_test(0, testCases[idx]);
+            run_test_captured(testCases[idx], result);
+            g_watchdog.end_test(0);
+            count_failure(result);
+            report_result(idx, result);
+        }
+    }
+
+    /// @brief actually evaluate the tests (in parallel or in worker processes, if requested)
+    void run_tests()
+    {
+        // it's feasible the test functions might try to print to std::cout... but we're printing the result (pass/fail)
+        // of the tests there. We don't want to pollute the output too much! Instead, std::cout is routed per thread: a
+        // thread running a test captures the output into the test's result (which is written to the log file along
+        // with a "header" for the test), while this thread keeps printing to the console
+        //
+        // all that being said, the output of the tests is discarded if the bTESTS_NO_LOG preprocessor macro is defined
+
+        const CoutRouting routing;
+
+        std::cout << "RUNNING TESTS...\n";
+
+        if (is_isolated())
+        {
+#    ifndef _WIN32
+            run_tests_isolated();
+#    endif // !_WIN32
+        }
+        else if (get_number_of_jobs() > 1 || get_number_of_async_tests() > 0)
+        {
+            run_tests_parallel();
+        }
+        else
+        {
+            run_tests_serial();
+        }
+        g_eventLoop.stop();
+
+        // write out whatever is still batched, and erase the progress line (with "--quiet")
+        update_progress(get_number_of_tests(), true);
+    }
+
+    /// @brief runs a benchmark function once
+    /// @param testCase the benchmark to run
+    /// @param iterations the number of iterations the benchmark should loop for
+    /// @param elapsedNs set to the time taken by the loop (in nanoseconds)
+    /// @param counters set to the hardware events counted in the loop (if "--counters" was given)
+    /// @return true if the benchmark ran successfully (false if it failed, so the measurements should stop)
+    bool time_benchmark(const TestCase &testCase, size_t iterations, double &elapsedNs, CounterValues &counters)
+    {
+        ben::tests::Benchmark state{iterations};
+        loop_counters().counted = CounterValues{};
+        testCase.benchmark(state);
+        counters = loop_counters().counted;
+        if (current_result()->failures > 0)
+        {
+            return false;
+        }
+        if (!state.started())
+        {
+            record_failure_in(*current_result(), "benchmark did not loop over its state", {});
+            return false;
+        }
+        elapsedNs = std::chrono::duration<double, std::nano>{state.elapsed()}.count();
+        return true;
+    }
+
+    /// @brief warms up, calibrates, and then measures a benchmark
+    /// @param testCase the benchmark to run
+    /// @param result the result of the benchmark
+    void run_benchmark_captured(const TestCase &testCase, BenchmarkResult &result)
+    {
+        const std::string_view previousGroup{current_group()};
+        current_group() = testCase.group;
+        run_captured(result.result, [&]() {
+            constexpr double warmupNs{bTESTS_BENCHMARK_WARMUP_MS * 1e6};
+            constexpr double sampleNs{bTESTS_BENCHMARK_SAMPLE_MS * 1e6};
+
+            // warm up (caches, branch predictors, clock speeds...) while growing the number of iterations until a
+            // single run takes about as long as a sample should
+            size_t iterations{1};
+            double warmedUp{0.0};
+            while (true)
+            {
+                double        elapsed{0.0};
+                CounterValues counters;
+                if (!time_benchmark(testCase, iterations, elapsed, counters))
+                {
+                    return;
+                }
+                warmedUp += elapsed;
+
+                const bool calibrated{elapsed >= sampleNs};
+                if (calibrated && warmedUp >= warmupNs)
+                {
+                    break;
+                }
+                if (!calibrated)
+                {
+                    // aim a little past the target, growing by at most 10x per run so a noisy run can't overshoot
+                    const double scale{elapsed > 0.0 ? (sampleNs * 1.2) / elapsed : 10.0};
+                    iterations = std::max(iterations + 1, static_cast<size_t>(iterations * std::min(scale, 10.0)));
+                }
+            }
+
+            result.iterations = iterations;
+            {
+                const AllocationPause pause;
+                result.samples.reserve(bTESTS_BENCHMARK_SAMPLES);
+            }
+            for (size_t sample{0}; sample < bTESTS_BENCHMARK_SAMPLES; sample++)
+            {
+                double        elapsed{0.0};
+                CounterValues counters;
+                if (!time_benchmark(testCase, iterations, elapsed, counters))
+                {
+                    return;
+                }
+                result.samples.push_back(elapsed / static_cast<double>(iterations));
+                add_counters(result.counters, counters);
+            }
+        });
+        current_group() = previousGroup;
+    }
+
+    /// @brief gets the median of some (sorted) samples
+    /// @param sorted the samples, in ascending order (must not be empty)
+    /// @return the median
+    double get_median(const std::vector<double> &sorted)
+    {
+        const size_t count{sorted.size()};
+        return count % 2 == 1 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+    }
+
+    /// @brief works out the (two-sided) p-value of a Mann-Whitney U test between two sets of samples
+    ///
+    /// the test only compares the ranks of the samples, so it doesn't assume they're normally distributed (benchmark
+    /// timings rarely are) and a few outliers can't swing it. The normal approximation (with corrections for ties and
+    /// continuity) is used, which is accurate for the usual number of samples
+    ///
+    /// @param first the first set of samples
+    /// @param second the second set of samples
+    /// @return the probability of seeing a difference at least this large if both sets came from the same distribution
+    double mann_whitney_p(const std::vector<double> &first, const std::vector<double> &second)
+    {
+        if (first.empty() || second.empty())
+        {
+            return 1.0;
+        }
+
+        // rank the samples together (ties share the average of their ranks), adding up the ranks of the first set
+        std::vector<std::pair<double, bool>> combined;
+        combined.reserve(first.size() + second.size());
+        for (const double sample : first)
+        {
+            combined.emplace_back(sample, true);
+        }
+        for (const double sample : second)
+        {
+            combined.emplace_back(sample, false);
+        }
+        std::sort(combined.begin(), combined.end());
+
+        double firstRanks{0.0};
+        double ties{0.0}; // the sum of t^3 - t over each group of t tied samples
+        for (size_t start{0}; start < combined.size();)
+        {
+            size_t end{start + 1};
+            while (end < combined.size() && combined[end].first == combined[start].first)
+            {
+                end++;
+            }
+            const double rank{static_cast<double>(start + 1 + end) / 2.0};
+            for (size_t idx{start}; idx < end; idx++)
+            {
+                firstRanks += combined[idx].second ? rank : 0.0;
+            }
+            const double tied{static_cast<double>(end - start)};
+            ties += tied * tied * tied - tied;
+            start = end;
+        }
+
+        const double n1{static_cast<double>(first.size())};
+        const double n2{static_cast<double>(second.size())};
+        const double n{n1 + n2};
+        const double u{firstRanks - n1 * (n1 + 1.0) / 2.0};
+        const double variance{n1 * n2 / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0)))};
+        if (!(variance > 0.0))
+        {
+            return 1.0;
+        }
+        const double z{std::max(0.0, std::abs(u - n1 * n2 / 2.0) - 0.5) / std::sqrt(variance)};
+        return std::erfc(z / std::sqrt(2.0));
+    }
+
+    /// @brief compares a benchmark with its baseline (if it has one)
+    /// @param testCase the benchmark
+    /// @param result the result of the benchmark
+    /// @param stats the statistics of the benchmark's samples
+    /// @return the comparison; a change only counts if it's both significant and bigger than the threshold, so noise
+    /// (and small but consistent shifts) don't fail the run
+    BaselineComparison compare_with_baseline(
+        const TestCase        &testCase,
+        const BenchmarkResult &result,
+        const BenchmarkStats  &stats)
+    {
+        BaselineComparison comparison;
+        const auto         baseline{g_baseline.find(get_history_key(testCase))};
+        if (baseline == g_baseline.end() || baseline->second.empty() || result.samples.empty())
+        {
+            return comparison;
+        }
+
+        std::vector<double> sorted{baseline->second};
+        std::sort(sorted.begin(), sorted.end());
+        const double baselineMedian{get_median(sorted)};
+        if (!(baselineMedian > 0.0))
+        {
+            return comparison;
+        }
+
+        comparison.change = (stats.median / baselineMedian - 1.0) * 100.0;
+        comparison.p      = mann_whitney_p(sorted, result.samples);
+        if (comparison.p >= bTESTS_BASELINE_SIGNIFICANCE || std::abs(comparison.change) < g_options.regressionThreshold)
+        {
+            comparison.verdict = BaselineVerdict::unchanged;
+        }
+        else
+        {
+            comparison.verdict = (comparison.change > 0.0 ? BaselineVerdict::regressed : BaselineVerdict::improved);
+        }
+        return comparison;
+    }
+
+    /// @brief counts the benchmarks which compared with the baseline in a given way
+    /// @param verdict the outcome of the comparison to count
+    /// @return the number of benchmarks
+    size_t count_comparisons(BaselineVerdict verdict)
+    {
+        return static_cast<size_t>(
+            std::count_if(g_comparisons.begin(), g_comparisons.end(), [verdict](const BaselineComparison &comparison) {
+                return comparison.verdict == verdict;
+            }));
+    }
+
+    /// @brief the bytes every run in the trend file starts with
+    static constexpr std::string_view g_trendMagic{"bTRN"};
+
+    /// @brief the layout of the runs in the trend file (bumped if it ever changes)
+    static constexpr uint64_t g_trendVersion{1};
+
+    /// @brief the size of the header of a run in the trend file (before its tag)
+    static constexpr size_t g_trendHeaderBytes{24};
+
+    /// @brief the size of the record of one test in a run in the trend file (its id, flags, and metrics)
+    static constexpr size_t g_trendRecordBytes{8 + 1 + 4 * static_cast<size_t>(TrendMetric::count)};
+
+    /// @brief appends what this run measured to the trend file (if there is one)
+    ///
+    /// the trend file is only ever appended to, one block per run, with every number little-endian: the magic "bTRN",
+    /// the version (u32), the number of records N (u32), the length of the tag T (u32), the time of the run (i64,
+    /// seconds since the Unix epoch), the T bytes of the tag, and then the records column by column-- N ids (u64, see
+    /// hash_test_case()), N flags (u8), and N values (f32) of each metric in turn (see TrendMetric). A run costs 41
+    /// bytes per test, and reading the trend of one test only touches its own row of each column
+    void write_trend()
+    {
+        if (g_options.trendFile.empty() || g_trendRecords.empty())
+        {
+            return;
+        }
+
+        const PhaseTimer timer{RunnerPhase::log};
+        const auto       seconds{std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch())};
+
+        std::string block;
+        block.reserve(g_trendHeaderBytes + g_options.trendTag.size() + g_trendRecords.size() * g_trendRecordBytes);
+        const auto put = [&block](uint64_t value, size_t bytes) {
+            for (size_t byte{0}; byte < bytes; byte++)
+            {
+                block.push_back(static_cast<char>((value >> (8 * byte)) & 0xff));
+            }
+        };
+        block.append(g_trendMagic);
+        put(g_trendVersion, 4);
+        put(g_trendRecords.size(), 4);
+        put(g_options.trendTag.size(), 4);
+        put(static_cast<uint64_t>(seconds.count()), 8);
+        block.append(g_options.trendTag);
+        for (const TrendRecord &record : g_trendRecords)
+        {
+            put(record.id, 8);
+        }
+        for (const TrendRecord &record : g_trendRecords)
+        {
+            put(record.flags, 1);
+        }
+        for (size_t metric{0}; metric < static_cast<size_t>(TrendMetric::count); metric++)
+        {
+            for (const TrendRecord &record : g_trendRecords)
+            {
+                put(std::bit_cast<uint32_t>(record.metrics[metric]), 4);
+            }
+        }
+
+        // the block goes out in one write, so a run which is killed part way through leaves (at most) one torn block
+        std::ofstream file{g_options.trendFile, std::ios::binary | std::ios::app};
+        file.write(block.data(), static_cast<std::streamsize>(block.size()));
+        if (!file)
+        {
+            std::cout << "ERROR:\tCould not append this run to the trend file '" << g_options.trendFile << "'.\n";
+        }
+    }
+
+    /// @brief reads the runs of some tests back from the trend file
+    /// @param path the trend file
+    /// @param trends the runs of each test, keyed by the id of the test (see hash_test_case()); only the tests which
+    /// are already keys are read, and their runs are added oldest first
+    /// @return true if the file could be read; a block which is torn (or otherwise not a run) is skipped
+    bool read_trend(const std::string &path, std::map<uint64_t, std::vector<TrendPoint>> &trends)
+    {
+        std::ifstream file{path, std::ios::binary | std::ios::ate};
+        if (!file)
+        {
+            return false;
+        }
+        std::string data(static_cast<size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        if (!file.read(data.data(), static_cast<std::streamsize>(data.size())))
+        {
+            return false;
+        }
+
+        const auto get = [&data](size_t offset, size_t bytes) {
+            uint64_t value{0};
+            for (size_t byte{bytes}; byte-- > 0;)
+            {
+                value = (value << 8) | static_cast<unsigned char>(data[offset + byte]);
+            }
+            return value;
+        };
+        const auto starts_run = [&data](size_t offset) {
+            return data.compare(offset, g_trendMagic.size(), g_trendMagic) == 0;
+        };
+
+        size_t offset{0};
+        while (offset + g_trendHeaderBytes <= data.size())
+        {
+            // a run must fill the file up to the next run (or to its end); anything else is skipped over
+            const size_t count{get(offset + 8, 4)};
+            const size_t tagBytes{get(offset + 12, 4)};
+            const size_t columns{offset + g_trendHeaderBytes + tagBytes};
+            const bool   fits{columns <= data.size() && count <= (data.size() - columns) / g_trendRecordBytes};
+            const size_t end{fits ? columns + count * g_trendRecordBytes : data.size()};
+            if (!starts_run(offset) || get(offset + 4, 4) != g_trendVersion || !fits ||
+                (end < data.size() && !starts_run(end)))
+            {
+                const size_t next{data.find(g_trendMagic, offset + 1)};
+                offset = (next == std::string::npos ? data.size() : next);
+                continue;
+            }
+
+            for (size_t row{0}; row < count; row++)
+            {
+                const auto found{trends.find(get(columns + row * 8, 8))};
+                if (found == trends.end())
+                {
+                    continue;
+                }
+                TrendPoint point{static_cast<int64_t>(get(offset + 16, 8)),
+                                 data.substr(offset + g_trendHeaderBytes, tagBytes),
+                                 {found->first, static_cast<uint8_t>(data[columns + count * 8 + row]), {}}};
+                for (size_t metric{0}; metric < point.record.metrics.size(); metric++)
+                {
+                    const size_t at{columns + count * 9 + (metric * count + row) * 4};
+                    point.record.metrics[metric] = std::bit_cast<float>(static_cast<uint32_t>(get(at, 4)));
+                }
+                found->second.push_back(std::move(point));
+            }
+            offset = end;
+        }
+        return true;
+    }
+
+    /// @brief finds the run at which a series of times stepped up (or down), if they did
+    ///
+    /// the series is split where each side fits its own mean best (least squares, on the logarithms of the times, so
+    /// a doubling counts the same wherever it happens), keeping at least bTESTS_TREND_MIN_RUNS runs on each side. The
+    /// split is only a step change if the sides differ like a benchmark has to differ from its baseline: significantly
+    /// (by a Mann-Whitney U test, at bTESTS_TREND_SIGNIFICANCE) and by more than "--regression-threshold" percent
+    ///
+    /// @param times the times of the runs, oldest first (all positive)
+    /// @param at set to the index of the first run after the split
+    /// @return how the runs after the split compare with the runs before it (none if there are too few runs)
+    BaselineComparison find_step_change(const std::vector<double> &times, size_t &at)
+    {
+        BaselineComparison comparison;
+        const size_t       minRuns{std::max<size_t>(1, bTESTS_TREND_MIN_RUNS)};
+        if (times.size() < 2 * minRuns)
+        {
+            return comparison;
+        }
+
+        // the best split keeps the most of the sum of squares in the means of its sides
+        double total{0.0};
+        for (const double time : times)
+        {
+            total += std::log(time);
+        }
+        double before{0.0};
+        double best{-1.0};
+        for (size_t split{1}; split < times.size(); split++)
+        {
+            before += std::log(times[split - 1]);
+            const double left{static_cast<double>(split)};
+            const double right{static_cast<double>(times.size() - split)};
+            const double explained{before * before / left + (total - before) * (total - before) / right};
+            if (split >= minRuns && times.size() - split >= minRuns && (best < 0.0 || explained > best))
+            {
+                best = explained;
+                at   = split;
+            }
+        }
+
+        std::vector<double> first{times.begin(), times.begin() + static_cast<std::ptrdiff_t>(at)};
+        std::vector<double> second{times.begin() + static_cast<std::ptrdiff_t>(at), times.end()};
+        std::sort(first.begin(), first.end());
+        std::sort(second.begin(), second.end());
+        comparison.change = (get_median(second) / get_median(first) - 1.0) * 100.0;
+        comparison.p      = mann_whitney_p(first, second);
+        if (comparison.p >= bTESTS_TREND_SIGNIFICANCE || std::abs(comparison.change) < g_options.regressionThreshold)
+        {
+            comparison.verdict = BaselineVerdict::unchanged;
+        }
+        else
+        {
+            comparison.verdict = (comparison.change > 0.0 ? BaselineVerdict::regressed : BaselineVerdict::improved);
+        }
+        return comparison;
+    }
+
+    /// @brief describes one run of a test in the trend file
+    /// @param point the run
+    /// @return the description, e.g. "2024-01-02 03:04  abc123  passed  1.23 ms, 1.20 ms CPU, 12 allocations (345 B)"
+    std::string describe_trend_point(const TrendPoint &point)
+    {
+        const TrendRecord &record{point.record};
+        const auto         metric = [&record](TrendMetric which) {
+            return static_cast<double>(record.metrics[static_cast<size_t>(which)]);
+        };
+        const bool benchmark{(record.flags & TrendRecord::benchmarkFlag) != 0};
+
+        char              date[32]{"(unknown date)"};
+        const std::time_t seconds{static_cast<std::time_t>(point.time)};
+#    ifdef _MSC_VER
+#        pragma warning(suppress : 4996) // only this thread formats dates, so gmtime's shared result is fine
+#    endif                               // _MSC_VER
+        const std::tm *const utc{std::gmtime(&seconds)};
+        if (utc != nullptr)
+        {
+            std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M", utc);
+        }
+
+        constexpr std::array<const char *, 4> statuses{"passed", "FAILED", "CRASHED", "TIMED OUT"};
+        const size_t status{static_cast<size_t>(record.flags & TrendRecord::statusMask)};
+
+        std::string description{date};
+        description.append("  ").append(point.tag).append("  ");
+        description.append(status < statuses.size() ? statuses[status] : "unknown").append("  ");
+        description.append(format_nanoseconds(metric(TrendMetric::time))).append(benchmark ? "/op" : "");
+        if (metric(TrendMetric::cpu) > 0.0)
+        {
+            description.append(", ").append(format_nanoseconds(metric(TrendMetric::cpu))).append(" CPU");
+        }
+        if (metric(TrendMetric::allocations) > 0.0)
+        {
+            description.append(", ").append(std::to_string(static_cast<size_t>(metric(TrendMetric::allocations))));
+            description.append(" allocations (");
+            description.append(std::to_string(static_cast<size_t>(metric(TrendMetric::bytes)))).append(" B)");
+        }
+
+        // only the counters which were counted are recorded as anything but zero
+        CounterValues counters{0, metric(TrendMetric::cycles), metric(TrendMetric::instructions),
+                               metric(TrendMetric::cacheMisses), metric(TrendMetric::branchMisses)};
+        counters.events |= (counters.cycles > 0.0 ? CounterValues::cyclesEvent : 0);
+        counters.events |= (counters.instructions > 0.0 ? CounterValues::instructionsEvent : 0);
+        counters.events |= (counters.cacheMisses > 0.0 ? CounterValues::cacheMissesEvent : 0);
+        counters.events |= (counters.branchMisses > 0.0 ? CounterValues::branchMissesEvent : 0);
+        counters.events |= ((record.flags & TrendRecord::tscFlag) != 0 ? CounterValues::tscEvent : 0);
+        if (counters.events != 0)
+        {
+            description.append(", ").append(describe_counters(counters, 1.0, benchmark ? "/op" : ""));
+        }
+        return description;
+    }
+
+    /// @brief prints the runs of each test (and benchmark) matching "--trend" from the trend file, flagging the run
+    /// where its time stepped up or down (see find_step_change())
+    /// @return true if the trend file could be read and some test matched
+    bool print_trend()
+    {
+        if (g_options.trendFile.empty())
+        {
+            std::cout << "ERROR:\t'--trend' needs a trend file to read ('--trend-file FILE').\n";
+            return false;
+        }
+
+        std::vector<const TestCase *>               matches;
+        std::map<uint64_t, std::vector<TrendPoint>> trends;
+        for (const TestCase &testCase : get_selected_cases())
+        {
+            if (matches_glob(g_options.trendPattern, testCase.name))
+            {
+                matches.push_back(&testCase);
+                trends[hash_test_case(testCase)];
+            }
+        }
+        if (matches.empty())
+        {
+            std::cout << "ERROR:\tNo tests match '--trend " << g_options.trendPattern << "'.\n";
+            return false;
+        }
+        if (!read_trend(g_options.trendFile, trends))
+        {
+            std::cout << "ERROR:\tCould not read the trend file '" << g_options.trendFile << "'.\n";
+            return false;
+        }
+
+        std::string output;
+        for (const TestCase *testCase : matches)
+        {
+            const std::vector<TrendPoint> &points{trends[hash_test_case(*testCase)]};
+            output.append(testCase->benchmark != nullptr ? "TREND OF BENCHMARK '" : "TREND OF TEST '");
+            output.append(testCase->group).append("' / '").append(testCase->name).append("' (");
+            output.append(std::to_string(points.size())).append(points.size() == 1 ? " run):\n" : " runs):\n");
+
+            // only the runs which passed say anything about how long the test takes
+            std::vector<double> times;
+            std::vector<size_t> timed;
+            for (size_t idx{0}; idx < points.size(); idx++)
+            {
+                const double time{points[idx].record.metrics[static_cast<size_t>(TrendMetric::time)]};
+                if ((points[idx].record.flags & TrendRecord::statusMask) == 0 && time > 0.0)
+                {
+                    times.push_back(time);
+                    timed.push_back(idx);
+                }
+            }
+            size_t                   split{0};
+            const BaselineComparison change{find_step_change(times, split)};
+            const bool               stepped{change.verdict == BaselineVerdict::regressed ||
+                               change.verdict == BaselineVerdict::improved};
+
+            for (size_t idx{0}; idx < points.size(); idx++)
+            {
+                output.append("\t").append(describe_trend_point(points[idx]));
+                output.append(stepped && idx == timed[split] ? "  <-- step change\n" : "\n");
+            }
+            switch (change.verdict)
+            {
+            case BaselineVerdict::none:
+                output.append("\tToo few runs passed to look for a step change (it takes ");
+                output.append(std::to_string(2 * std::max<size_t>(1, bTESTS_TREND_MIN_RUNS))).append(").\n");
+                break;
+            case BaselineVerdict::unchanged:
+                output.append("\tNo step change: ").append(format_comparison(change)).append(" at the likeliest run");
+                output.append(" -- within the noise.\n");
+                break;
+            case BaselineVerdict::improved:
+            case BaselineVerdict::regressed:
+                output.append("\tStep change at the run tagged '").append(points[timed[split]].tag).append("': ");
+                output.append(format_comparison(change));
+                output.append(change.verdict == BaselineVerdict::regressed ? " -- REGRESSED.\n" : " -- improved.\n");
+                break;
+            }
+            output.append("--------------------------------------------------------------------------------\n");
+        }
+        std::cout << output;
+        return true;
+    }
+
+    /// @brief summarizes the samples of a benchmark
+    /// @param result the result of the benchmark
+    /// @return the min/median/mean/standard deviation of the time per iteration (all zero if there are no samples)
+    BenchmarkStats get_benchmark_stats(const BenchmarkResult &result)
+    {
+        BenchmarkStats stats;
+        if (result.samples.empty())
+        {
+            return stats;
+        }
+
+        std::vector<double> sorted{result.samples};
+        std::sort(sorted.begin(), sorted.end());
+
+        const size_t count{sorted.size()};
+        const double median{get_median(sorted)};
+
+        double mean{0.0};
+        for (const double sample : sorted)
+        {
+            mean += sample;
+        }
+        mean /= static_cast<double>(count);
+
+        double variance{0.0};
+        for (const double sample : sorted)
+        {
+            variance += (sample - mean) * (sample - mean);
+        }
+        variance /= static_cast<double>(count > 1 ? count - 1 : 1);
+
+        stats.min    = sorted.front();
+        stats.median = median;
+        stats.mean   = mean;
+        stats.stddev = std::sqrt(variance);
+        return stats;
+    }
+
+    /// @brief describes the measurements of a benchmark
+    /// @param result the result of the benchmark
+    /// @param stats the statistics of its samples
+    /// @return a description of the statistics of the benchmark (empty if there are no samples)
+    std::string describe_benchmark(const BenchmarkResult &result, const BenchmarkStats &stats)
+    {
+        if (result.samples.empty())
+        {
+            return {};
+        }
+
+        std::string description{"min "};
+        description.append(format_nanoseconds(stats.min)).append("/op, median ");
+        description.append(format_nanoseconds(stats.median)).append("/op, mean ");
+        description.append(format_nanoseconds(stats.mean)).append("/op, stddev ");
+        description.append(format_nanoseconds(stats.stddev)).append(", ");
+        description.append(stats.median > 0.0 ? format_rate(1e9 / stats.median) : std::string{"inf"});
+        description.append(" ops/s (").append(std::to_string(result.samples.size())).append(" samples of ");
+        description.append(std::to_string(result.iterations)).append(" iterations)");
+        if (result.counters.events != 0)
+        {
+            const double operations{static_cast<double>(result.iterations * result.samples.size())};
+            description.append(", ").append(describe_counters(result.counters, operations, "/op"));
+        }
+        return description;
+    }
+
+    /// @brief runs (and reports) the benchmarks one after another on the calling thread
+    ///
+    /// benchmarks always run serially, in this process, once all of the tests have finished-- so they aren't competing
+    /// with anything else for the machine
+    void run_benchmarks()
+    {
+        const std::vector<TestCase> &benchmarkCases{get_benchmark_cases()};
+        const CoutRouting            routing;
+
+        std::cout << "RUNNING BENCHMARKS...\n";
+
+        g_comparisons.resize(benchmarkCases.size());
+        g_benchmarkSamples.resize(g_options.saveBaselineFile.empty() ? 0 : benchmarkCases.size());
+
+        for (size_t idx{0}; idx < benchmarkCases.size(); idx++)
+        {
+            BenchmarkResult result;
+            g_watchdog.begin_test(0, benchmarkCases[idx]);
+            run_benchmark_captured(benchmarkCases[idx], result);
+            g_watchdog.end_test(0);
+            if (result.result.status != TestStatus::passed)
+            {
+                g_benchmarkFailures++;
+            }
+
+            const BenchmarkStats stats{get_benchmark_stats(result)};
+            std::string          details{describe_benchmark(result, stats)};
+            if (!g_options.saveBaselineFile.empty() && result.result.status == TestStatus::passed)
+            {
+                g_benchmarkSamples[idx] = result.samples;
+            }
+
+            g_comparisons[idx] = compare_with_baseline(benchmarkCases[idx], result, stats);
+            add_trend_record(benchmarkCases[idx], result.result, result.counters, stats.median,
+                             static_cast<double>(std::max<size_t>(1, result.iterations * result.samples.size())));
+            switch (g_comparisons[idx].verdict)
+            {
+            case BaselineVerdict::none:
+                break;
+            case BaselineVerdict::unchanged:
+                details.append("\n\t\tbaseline: ").append(format_comparison(g_comparisons[idx]));
+                details.append(" -- unchanged (within the noise)");
+                break;
+            case BaselineVerdict::improved:
+                details.append("\n\t\tbaseline: ").append(format_comparison(g_comparisons[idx]));
+                details.append(" -- improved");
+                break;
+            case BaselineVerdict::regressed:
+                details.append("\n\t\tbaseline: ").append(format_comparison(g_comparisons[idx]));
+                details.append(" -- REGRESSED");
+                break;
+            }
+
+            const bool newGroup{idx == 0 || benchmarkCases[idx - 1].group != benchmarkCases[idx].group};
+            report_case(benchmarkCases[idx], idx + 1, newGroup, result.result, details);
+            for (const std::unique_ptr<Reporter> &reporter : g_reporters)
+            {
+                reporter->report_benchmark(benchmarkCases[idx], result, stats, g_comparisons[idx]);
+            }
+
+            if (idx + 1 == benchmarkCases.size() || benchmarkCases[idx + 1].group != benchmarkCases[idx].group)
+            {
+                tear_down_fixtures(&benchmarkCases[idx].group);
+            }
+        }
+    }
+
+    /// @brief describes where the time of the run went, phase by phase (see "--profile-runner")
+    /// @return the description (a section of the summary)
+    std::string describe_runner_profile()
+    {
+        constexpr std::array<const char *, static_cast<size_t>(RunnerPhase::count)> names{
+            "registration  ", "scheduling    ", "output capture", "log I/O       ", "reporting     ", "test bodies   "};
+
+        std::array<double, static_cast<size_t>(RunnerPhase::count)> phaseNs{};
+        for (size_t idx{0}; idx < phaseNs.size(); idx++)
+        {
+            phaseNs[idx] = static_cast<double>(g_phaseNs[idx].load());
+        }
 #    ifndef bTESTS_NO_LOG
-                    // print a success message and line separator...
-                    std::cout << "\npassed.\n";
-                    print_line_separator();
+        // the writer thread's time (up to now) is log I/O too
+        phaseNs[static_cast<size_t>(RunnerPhase::log)] += static_cast<double>(get_tests_log().get_write_ns());
 #    endif // !bTESTS_NO_LOG
-           // and switch std::cout's rdbuf back to the old value!
-                    std::cout.set_rdbuf(coutBuffer);
-                    std::cout << "passed.\n";
-                    g_successes++;
-                }
 
-                // catch the exceptions (i.e. a failed test)
-                catch (const std::exception &e)
+        double totalNs{0.0};
+        for (const double ns : phaseNs)
+        {
+            totalNs += ns;
+        }
+        const double runnerNs{totalNs - phaseNs[static_cast<size_t>(RunnerPhase::tests)]};
+        const auto   percent = [totalNs](double ns) {
+            char text[16]{};
+            std::snprintf(text, sizeof(text), "%.1f%%", totalNs > 0.0 ? 100.0 * ns / totalNs : 0.0);
+            return std::string{text};
+        };
+
+        std::string profile{"RUNNER PROFILE (summed over every thread):\n"};
+        for (size_t idx{0}; idx < phaseNs.size(); idx++)
+        {
+            profile.append("\t").append(names[idx]).append(" : ").append(format_nanoseconds(phaseNs[idx]));
+            profile.append(" (").append(percent(phaseNs[idx])).append(")\n");
+        }
+        const size_t ran{get_number_of_tests() - g_testsNotRun};
+        profile.append("\tThe runner's own work took ").append(percent(runnerNs)).append(" of the time");
+        if (ran > 0)
+        {
+            profile.append(", ").append(format_nanoseconds(runnerNs / static_cast<double>(ran))).append(" per test");
+        }
+        profile.append(".\n--------------------------------------------------------------------------------\n");
+        return profile;
+    }
+
+    /// @brief prints a summary of the results (to the console and the log file)
+    void print_summary()
+    {
+        std::string summary{"--------------------------------------------------------------------------------\n"};
+        summary.append("SUMMARY:\n");
+        summary.append("\tPassed ").append(std::to_string(g_successes)).append(" out of ");
+        summary.append(std::to_string(get_number_of_tests())).append(" tests");
+        summary.append(g_cachedTests == 0 ? ".\n" : " (skipped " + std::to_string(g_cachedTests) + " cached).\n");
+        if (g_options.shuffle)
+        {
+            summary.append("\tShuffled with seed ").append(std::to_string(g_options.seed)).append(".\n");
+        }
+        if (g_stopStarting)
+        {
+            summary.append("\tStopped after ").append(std::to_string(g_failuresSoFar)).append(" failed test");
+            summary.append(g_failuresSoFar == 1 ? " ('--fail-fast'); " : "s ('--fail-fast'); ");
+            summary.append(std::to_string(g_testsNotRun)).append(" tests (and the benchmarks) weren't run.\n");
+        }
+        if (get_number_of_benchmarks() > 0 && !g_stopStarting)
+        {
+            summary.append("\tRan ").append(std::to_string(get_number_of_benchmarks())).append(" benchmark");
+            summary.append(get_number_of_benchmarks() == 1 ? " (" : "s (");
+            summary.append(std::to_string(g_benchmarkFailures)).append(" failed).\n");
+        }
+        if (!g_baseline.empty() && !g_comparisons.empty())
+        {
+            summary.append("\tCompared with the baseline: ");
+            summary.append(std::to_string(count_comparisons(BaselineVerdict::regressed))).append(" regressed, ");
+            summary.append(std::to_string(count_comparisons(BaselineVerdict::improved))).append(" improved, ");
+            summary.append(std::to_string(count_comparisons(BaselineVerdict::unchanged))).append(" unchanged, ");
+            summary.append(std::to_string(count_comparisons(BaselineVerdict::none))).append(" not compared.\n");
+        }
+        summary.append("--------------------------------------------------------------------------------\n");
+
+        // list the regressions and the improvements separately, so the noise doesn't hide either of them
+        for (const auto &[verdict, title] : {std::pair{BaselineVerdict::regressed, "REGRESSED BENCHMARKS:\n"},
+                                             std::pair{BaselineVerdict::improved, "IMPROVED BENCHMARKS:\n"}})
+        {
+            if (count_comparisons(verdict) == 0)
+            {
+                continue;
+            }
+            summary.append(title);
+            for (size_t idx{0}; idx < g_comparisons.size(); idx++)
+            {
+                if (g_comparisons[idx].verdict == verdict)
                 {
+                    const TestCase &testCase{get_benchmark_cases()[idx]};
+                    summary.append("\t").append(format_comparison(g_comparisons[idx])).append(" : '");
+                    summary.append(testCase.group).append("' / '").append(testCase.name).append("'\n");
+                }
+            }
+            summary.append("--------------------------------------------------------------------------------\n");
+        }
+
+        // list the slowest tests (by wall time), so it's clear where the time went
+        std::vector<size_t> slowest;
+        for (size_t idx{0}; idx < g_timings.size(); idx++)
+        {
+            if (g_timings[idx].ran)
+            {
+                slowest.push_back(idx);
+            }
+        }
+        const size_t count{std::min(g_options.slowest, slowest.size())};
+        std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(), [](size_t lhs, size_t rhs) {
+            return g_timings[lhs].wallNs > g_timings[rhs].wallNs;
+        });
+        if (count > 0)
+        {
+            summary.append("SLOWEST ").append(std::to_string(count));
+            summary.append(count == 1 ? " TEST:\n" : " TESTS:\n");
+            for (size_t idx{0}; idx < count; idx++)
+            {
+                const TestCase &testCase{get_test_cases()[slowest[idx]]};
+                summary.append("\t").append(format_nanoseconds(g_timings[slowest[idx]].wallNs)).append(" wall, ");
+                summary.append(format_nanoseconds(g_timings[slowest[idx]].cpuNs)).append(" cpu : '");
+                summary.append(testCase.group).append("' / '").append(testCase.name).append("'\n");
+            }
+            summary.append("--------------------------------------------------------------------------------\n");
+        }
+
+        if (g_options.profileRunner)
+        {
+            summary.append(describe_runner_profile());
+        }
+
+        std::cout.write(summary.data(), static_cast<std::streamsize>(summary.size()));
 #    ifndef bTESTS_NO_LOG
-                    // print the error location and line separator...
-                    std::cout << "\nfailed at '" << e.what() << "'.\n";
-                    print_line_separator();
+        get_tests_log().write(summary.data(), static_cast<std::streamsize>(summary.size()));
 #    endif // !bTESTS_NO_LOG
-           // and switch std::cout's rdbuf back to the old value!
-                    std::cout.set_rdbuf(coutBuffer);
-                    std::cout << "failed at '" << e.what() << "'.\n";
+    }
+} // namespace
+
+ben::tests::UnitTest::UnitTest(
+    const char             *name,
+    ben::tests::bTestFnType func,
+    const char             *group,
+    const char             *attributes)
+    : m_registration{name, group, func, nullptr, attributes, detail::g_registrations}
+{
+    // push this test onto the front of the list (there's nothing to allocate)
+    detail::g_registrations = &m_registration;
+}
+
+ben::tests::UnitTest::UnitTest(
+    const char                  *name,
+    ben::tests::bBenchmarkFnType func,
+    const char                  *group,
+    const char                  *attributes)
+    : m_registration{name, group, nullptr, func, attributes, detail::g_registrations}
+{
+    detail::g_registrations = &m_registration;
+}
+
+#    ifdef bTESTS_SELF_BENCHMARK
+namespace
+{
+    /// @brief the body of every test registered by the self benchmark
+    void empty_test() {}
+
+    /// @brief registers bTESTS_SELF_BENCHMARK_TESTS empty tests (in the group "bTESTS self benchmark"), so the time
+    /// the runner itself takes per test can be measured, e.g. with "--profile-runner"
+    class SelfBenchmark
+    {
+      public:
+        /// @brief registers the tests (they're named "empty[index]", like the cases of a parameterized test)
+        SelfBenchmark() : m_names(bTESTS_SELF_BENCHMARK_TESTS), m_registrations(bTESTS_SELF_BENCHMARK_TESTS)
+        {
+            const size_t width{std::to_string(m_names.size() > 0 ? m_names.size() - 1 : 0).size()};
+            for (size_t idx{0}; idx < m_names.size(); idx++)
+            {
+                const std::string index{std::to_string(idx)};
+                m_names[idx].assign("empty[").append(width - index.size(), '0').append(index).append("]");
+                m_registrations[idx] = ben::tests::detail::Registration{
+                    m_names[idx].c_str(), "bTESTS self benchmark", &empty_test, nullptr, "",
+                    ben::tests::detail::g_registrations};
+                ben::tests::detail::g_registrations = &m_registrations[idx];
+            }
+        }
+
+        // the registrations point into this object, so it can't be copied or moved
+        SelfBenchmark(const SelfBenchmark &)            = delete;
+        SelfBenchmark &operator=(const SelfBenchmark &) = delete;
+
+      private:
+        std::vector<std::string>                      m_names;         ///< the names of the tests
+        std::vector<ben::tests::detail::Registration> m_registrations; ///< the registrations of the tests
+    };
+
+    /// @brief the self benchmark's tests
+    static SelfBenchmark g_selfBenchmark{};
+} // namespace
+#    endif // bTESTS_SELF_BENCHMARK
+
+#    ifdef bTESTS_SELF_TEST
+namespace
+{
+    /// @brief the body of the short async tests registered by the self test (well within their timeouts)
+    ben::tests::Task<> short_async_test()
+    {
+        co_await ben::tests::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    /// @brief the body of the long async test registered by the self test, which outlives the timeouts of the short
+    /// tests before it
+    ben::tests::Task<> long_async_test()
+    {
+        co_await ben::tests::sleep_for(std::chrono::milliseconds{400});
+    }
+
+    /// @brief registers the framework's own regression tests (in the group "bTESTS self test")
+    ///
+    /// "async_deadline[NN]" finish straight away with short timeouts, then "async_deadline_reuse" (which runs alone)
+    /// sleeps past them-- it used to be timed out by a deadline of an earlier test whose memory it reused
+    class SelfTest
+    {
+      public:
+        /// @brief registers the tests
+        SelfTest()
+        {
+            for (size_t idx{0}; idx < m_registrations.size(); idx++)
+            {
+                const bool last{idx + 1 == m_registrations.size()};
+                const std::string index{std::to_string(idx)};
+                m_names[idx].assign(last ? "async_deadline_reuse" : "async_deadline[");
+                if (!last)
+                {
+                    m_names[idx].append(2 - std::min<size_t>(2, index.size()), '0').append(index).append("]");
                 }
-                idx++;
+                m_registrations[idx] = ben::tests::detail::Registration{
+                    m_names[idx].c_str(), "bTESTS self test", nullptr, nullptr,
+                    last ? "timeout=5, exclusive" : "timeout=0.1", ben::tests::detail::g_registrations, 0,
+                    last ? &long_async_test : &short_async_test};
+                ben::tests::detail::g_registrations = &m_registrations[idx];
             }
         }
+
+        // the registrations point into this object, so it can't be copied or moved
+        SelfTest(const SelfTest &)            = delete;
+        SelfTest &operator=(const SelfTest &) = delete;
+
+      private:
+        std::array<std::string, 17>                      m_names;         ///< the names of the tests
+        std::array<ben::tests::detail::Registration, 17> m_registrations; ///< the registrations of the tests
+    };
+
+    /// @brief the self test's tests
+    static SelfTest g_selfTest{};
+} // namespace
+#    endif // bTESTS_SELF_TEST
+
+void ben::tests::detail::use_pointer(const volatile void *) {}
+
+void *ben::tests::detail::get_fixture(
+    FixtureScope scope,
+    const void  *type,
+    void *(*create)(),
+    void (*destroy)(void *))
+{
+    FixtureKey key{scope, {}, {}, type};
+    if (scope != FixtureScope::suite)
+    {
+        key.group.assign(current_group());
+    }
+    if (scope == FixtureScope::thread)
+    {
+        key.thread = std::this_thread::get_id();
     }
 
-    /// @brief prints a summary of the results
-    void print_summary()
+    std::shared_ptr<Fixture> fixture;
     {
-        print_line_separator();
-        std::cout << "SUMMARY:\n";
-        std::cout << "\tPassed " << g_successes << " out of " << get_number_of_tests() << " tests.\n";
-        print_line_separator();
+        const AllocationPause pause;
+        std::lock_guard       lock{g_fixturesMutex};
+        std::shared_ptr<Fixture> &slot{g_fixtures[key]};
+        if (slot == nullptr)
+        {
+            slot = std::make_shared<Fixture>();
+        }
+        fixture = slot;
+    }
 
-#    ifndef bTESTS_NO_LOG
-        // save a pointer to the original std::cout buffer...
-        std::streambuf *const coutBuffer{std::cout.rdbuf()};
-        // set the std::cout's rdbuf to the output file stream...
-        std::cout.set_rdbuf(g_testsLog.rdbuf());
-        print_line_separator();
-        std::cout << "SUMMARY:\n";
-        std::cout << "\tPassed " << g_successes << " out of " << get_number_of_tests() << " tests.\n";
-        print_line_separator();
-        // and switch std::cout's rdbuf back to the old value!
-        std::cout.set_rdbuf(coutBuffer);
-#    endif // !bTESTS_NO_LOG
+    // construct the fixture outside of the lock, so (slow) fixtures for different groups are built in parallel; any
+    // other tests which want this fixture wait until it's built. If the constructor throws, the next test to ask for
+    // the fixture tries again
+    std::call_once(fixture->created, [&]() {
+        // fixtures outlive the test which happens to create them, so they don't count as its allocations (or leaks)
+        const AllocationPause pause;
+        fixture->object  = create();
+        fixture->destroy = destroy;
+        fixture->order   = g_fixturesCreated++;
+    });
+    return fixture->object;
+}
+
+void ben::tests::detail::record_failure(const char *file, unsigned line, const char *expression) noexcept
+{
+    TestResult *const result{current_result()};
+    if (result == nullptr)
+    {
+        return;
     }
-} // namespace
 
-ben::tests::UnitTest::UnitTest(const char *name, ben::tests::bTestFnType func, const char *group)
+    const AllocationPause pause;
+    const std::string     location{std::string{file} + ":" + std::to_string(line)};
+    record_failure_in(*result, location, expression);
+
+    // list every failed expectation in the log, in amongst the rest of the test's output
+    std::streambuf *const log{ThreadRoutingBuffer::target()};
+    if (log != nullptr)
+    {
+        const std::string entry{"expectation failed at '" + location + "' (" + expression + ")\n"};
+        log->sputn(entry.data(), static_cast<std::streamsize>(entry.size()));
+    }
+}
+
+uint64_t &ben::tests::detail::current_async_test() noexcept
+{
+    thread_local uint64_t t_test{0};
+    return t_test;
+}
+
+void ben::tests::detail::post_to_loop(uint64_t test, std::coroutine_handle<> handle, long long delayNs)
+{
+    g_eventLoop.post(test, handle, delayNs);
+}
+
+size_t ben::tests::detail::get_property_cases() noexcept
+{
+    return g_options.propertyCases;
+}
+
+uint64_t ben::tests::detail::get_property_seed(const char *name) noexcept
+{
+    return get_fingerprint(name) ^ static_cast<uint64_t>(g_options.propertySeed);
+}
+
+bool ben::tests::detail::run_property_trial(void (*trial)(const void *), const void *context)
+{
+    // the trial's output (and failures) go into a result of its own, which is thrown away
+    TestResult result;
+    run_captured(result, [trial, context]() { trial(context); });
+    return result.failures == 0;
+}
+
+size_t ben::tests::detail::get_failure_count() noexcept
+{
+    const TestResult *const result{current_result()};
+    return (result == nullptr ? 0 : result->failures);
+}
+
+void ben::tests::detail::log_property_failure(const std::string &message)
+{
+    std::cout << message << " (to reproduce, run with '--property-seed " << g_options.propertySeed << "')\n";
+}
+
+void ben::tests::detail::fail_fuzz_input(const std::string &description)
+{
+    std::fprintf(stderr, "property failed on the input: %s\n", description.c_str());
+    std::fflush(stderr);
+    std::abort();
+}
+
+std::string ben::tests::detail::describe_real(double value)
+{
+    char buffer[32]{};
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+size_t ben::tests::detail::get_allocation_count() noexcept
 {
-    // if the group does not exist, we first need to create it...
-    std::string groupString{group};
-    if (!get_tests().contains(groupString))
+    return thread_allocations().allocations;
+}
+
+bool ben::tests::detail::check_allocations(size_t allocations, size_t maxAllocations) noexcept
+{
+    const AllocationPause pause;
+#    ifdef bTESTS_TRACK_ALLOCATIONS
+    if (allocations <= maxAllocations)
+    {
+        return true;
+    }
+    const std::string entry{
+        "made " + std::to_string(allocations) + " allocation(s), at most " + std::to_string(maxAllocations) +
+        " allowed\n"};
+#    else
+    static_cast<void>(allocations);
+    static_cast<void>(maxAllocations);
+    const std::string entry{"allocations aren't tracked (define bTESTS_TRACK_ALLOCATIONS to count them)\n"};
+#    endif // bTESTS_TRACK_ALLOCATIONS
+
+    std::streambuf *const log{ThreadRoutingBuffer::target()};
+    if (log != nullptr)
+    {
+        log->sputn(entry.data(), static_cast<std::streamsize>(entry.size()));
+    }
+    return false;
+}
+
+void ben::tests::detail::begin_loop_counters() noexcept
+{
+    if (g_options.counters)
+    {
+        loop_counters().start = read_counters();
+    }
+}
+
+void ben::tests::detail::end_loop_counters() noexcept
+{
+    if (g_options.counters)
     {
-        get_tests().insert_or_assign(groupString, std::unordered_map<std::string, ben::tests::bTestFnType>{});
+        LoopCounters &loop{loop_counters()};
+        loop.counted = subtract_counters(loop.start, read_counters());
     }
+}
+
+// replace the global operator new/delete (every form of them) to count the allocations made by each thread
+#    ifdef bTESTS_TRACK_ALLOCATIONS
+void *operator new(std::size_t size)
+{
+    return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate_or_null(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate_or_null(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocate_or_null(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocate_or_null(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *memory) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+    deallocate_tracked(memory);
+}
 
-    // insert (or assign) so the value is updated if the same name is passed
-    std::string nameString{name};
-    get_tests().at(groupString).insert_or_assign(nameString, func);
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    deallocate_tracked(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    deallocate_tracked(memory);
 }
+#    endif // bTESTS_TRACK_ALLOCATIONS
 
 // only compile the main function if we're building the tests
 #    ifdef bBUILD_TESTS
 /// @brief main function (entry point for unit testing program)
-/// @return passing value if all tests pass, failure value if any test fails
-int main()
+/// @param argc the number of command line arguments
+/// @param argv the command line arguments ("--jobs N"/"-j N" runs the tests on N worker threads, "--isolate" runs them
+/// in worker processes, "--timeout S" limits how long each test may run for, "--global-timeout S" limits how long the
+/// whole run may take, "--no-benchmarks" skips the benchmarks, "--slowest N" lists the N slowest tests in the summary,
+/// "--quiet"/"-q" only prints the failing tests (and a progress line), "--shard-index I --total-shards N" only runs
+/// shard I of N, "--shard-timings FILE" balances the shards with the timings in a history file, "--history FILE" and
+/// "--no-history" choose (or disable) the history file, "--cache" skips the tests which passed last time (and haven't
+/// been rebuilt since) while "--no-cache" runs them all, "--fail-fast[=N]" stops starting tests after the first (or N)
+/// failures, "--failed-first" runs the tests which failed last time first, "--repeat N" runs each test N times,
+/// "--repeat-until-fail" stops repeating a test once it fails, "--stress K" runs each repetition on K threads at once,
+/// "--shuffle" shuffles the groups and the tests within them, "--seed N" shuffles them with the seed N,
+/// "--property-cases N" checks N inputs in each property test, "--property-seed N" generates different inputs for them,
+/// "--resource-limits R=N,..." lets N tests use the resource R at once, "--filter PATTERNS" and "--group PATTERNS" only
+/// run the tests whose names and groups match the (comma separated) glob patterns, patterns starting with '-' exclude
+/// tests, "--list" lists the tests instead of running them, "--junit FILE" and "--json FILE" write the results as JUnit
+/// XML or JSON lines, "--counters" counts hardware events, "--profile-runner" times the runner's own work by phase,
+/// "--save-baseline FILE" saves the benchmark samples as a baseline, and "--baseline FILE" compares the benchmarks with
+/// one, "--regression-threshold P" being the slowdown (in percent) which fails the run, "--trend-file FILE" appends the
+/// measurements of the run to a trend file, tagged with "--trend-tag TAG", and "--trend PATTERN" prints the trends of
+/// the matching tests from it (flagging any step change) instead of running them)
+/// @return passing value if all tests pass, failure value if any test fails, a benchmark regresses, or the arguments
+/// are invalid
+int main(int argc, char *argv[])
 {
+    if (!parse_arguments(argc, argv))
+    {
+        return static_cast<int>(ReturnValue::fail);
+    }
+
+    // the shards (and the order of parallel runs) depend on the history, so read it before the tests are collected
+    read_histories();
+
+    // collect the tests up front, so any problems with their attributes are reported before anything else
+    get_registered_cases();
+
+    // listing the tests doesn't run anything (or touch the log and history files)
+    if (g_options.list)
+    {
+        print_list();
+        return static_cast<int>(ReturnValue::pass);
+    }
+
+    // neither does printing the trends of some tests (from the runs before)
+    if (!g_options.trendPattern.empty())
+    {
+        return static_cast<int>(print_trend() ? ReturnValue::pass : ReturnValue::fail);
+    }
+
+    if (!create_reporters())
+    {
+        return static_cast<int>(ReturnValue::fail);
+    }
+
+    // work out what the tests need from the machine before describing the run
+    g_resourceGate.start(get_test_cases(), get_number_of_jobs());
     print_info();
 
-    // if no tests are found, we're done
-    if (get_tests().size() == 0)
+    // if no tests are found (or selected), we're done
+    if (get_selected_cases().empty())
     {
         return static_cast<int>(ReturnValue::pass);
     }
 
+    g_watchdog.start(get_number_of_jobs());
     run_tests();
 
+    if (get_number_of_benchmarks() > 0 && !g_stopStarting)
+    {
+        run_benchmarks();
+    }
+    g_watchdog.stop();
+    tear_down_fixtures(nullptr);
+
     print_summary();
+    write_history();
+    write_trend();
+    write_baseline();
+    for (const std::unique_ptr<Reporter> &reporter : g_reporters)
+    {
+        reporter->finish(g_successes, get_number_of_tests() - g_testsNotRun, g_benchmarkFailures);
+    }
 
-    // returns the "pass" value if all tests pass, or the "fail" value if any tests fail
-    return (
-        g_successes == get_number_of_tests() ? static_cast<int>(ReturnValue::pass)
-                                             : static_cast<int>(ReturnValue::fail));
+    // returns the "pass" value if all tests (and benchmarks) pass, or the "fail" value if any tests fail (or any
+    // benchmarks regressed compared with the baseline)
+    const bool passed{
+        g_successes == get_number_of_tests() && g_benchmarkFailures == 0 &&
+        count_comparisons(BaselineVerdict::regressed) == 0};
+    return passed ? static_cast<int>(ReturnValue::pass) : static_cast<int>(ReturnValue::fail);
 }
 #    endif // bBUILD_TESTS
 #    undef bTEST_IMPLEMENTATION